@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace benchmark {
+
+/**
+ * @brief Run a function concurrently on several threads and time it
+ *
+ * All threads are released at the same time; the returned duration spans
+ * from the release until the last thread has finished.
+ *
+ * @param numThreads Number of threads to start
+ * @param fn Function called with the index of the thread
+ * @return Elapsed time in seconds
+ */
+template <typename Function>
+double runOnThreads(uint32_t numThreads, Function&& fn)
+{
+    std::atomic<uint32_t> ready{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads);
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&, i]() {
+            ready.fetch_add(1, std::memory_order_relaxed);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            fn(i);
+        });
+    }
+
+    while (ready.load(std::memory_order_relaxed) < numThreads) {
+        std::this_thread::yield();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+/**
+ * @brief Print one result line
+ *
+ * @param name Name of the measured case
+ * @param numThreads Number of threads used
+ * @param operations Total number of operations performed by all threads
+ * @param seconds Elapsed time
+ */
+inline void printResult(const char* name, uint32_t numThreads, uint64_t operations,
+                        double seconds)
+{
+    double opsPerSecond = seconds > 0.0 ? static_cast<double>(operations) / seconds : 0.0;
+    std::printf("%-40s threads: %2u  %12.2f Mops/s  (%.3f s)\n", name, numThreads,
+                opsPerSecond / 1.0e6, seconds);
+}
+
+void runJobSystemBenchmarks();
+
+} // namespace benchmark
@@ -0,0 +1,110 @@
+#include "Benchmark.h"
+
+#include "ocf/core/job/JobFreeList.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using namespace ocf::job;
+
+namespace benchmark {
+
+namespace {
+
+constexpr size_t POOL_SIZE = 4096;
+constexpr size_t BATCH_SIZE = 8;
+constexpr uint32_t THREAD_COUNTS[] = {1, 4, 16};
+
+/**
+ * @brief Reference allocator reproducing the former linear CAS scan
+ */
+class LinearScanPool {
+public:
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    explicit LinearScanPool(size_t capacity)
+        : m_allocated(std::make_unique<std::atomic<bool>[]>(capacity))
+        , m_capacity(capacity)
+    {
+        for (size_t i = 0; i < capacity; ++i) {
+            m_allocated[i].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t allocate()
+    {
+        uint32_t poolSize = static_cast<uint32_t>(m_capacity);
+        uint32_t startIndex = m_next.fetch_add(1, std::memory_order_relaxed) % poolSize;
+        for (uint32_t i = 0; i < poolSize; ++i) {
+            uint32_t index = (startIndex + i) % poolSize;
+            bool expected = false;
+            if (m_allocated[index].compare_exchange_strong(expected, true,
+                                                           std::memory_order_acq_rel)) {
+                return index;
+            }
+        }
+        return INVALID_INDEX;
+    }
+
+    void free(uint32_t index) { m_allocated[index].store(false, std::memory_order_release); }
+
+private:
+    std::unique_ptr<std::atomic<bool>[]> m_allocated;
+    size_t m_capacity;
+    std::atomic<uint32_t> m_next{0};
+};
+
+/**
+ * @brief Allocate and free batches of indices from several threads
+ *
+ * A part of the pool is kept allocated for the whole run to reproduce a
+ * mostly busy pool, which is the worst case for the linear scan.
+ */
+template <typename Pool>
+void benchmarkAllocation(const char* name, float busyRatio, size_t operationsPerThread)
+{
+    for (uint32_t numThreads : THREAD_COUNTS) {
+        Pool pool(POOL_SIZE);
+
+        std::vector<uint32_t> busy;
+        size_t busyCount = static_cast<size_t>(POOL_SIZE * busyRatio);
+        for (size_t i = 0; i < busyCount; ++i) {
+            busy.push_back(pool.allocate());
+        }
+
+        double seconds = runOnThreads(numThreads, [&](uint32_t) {
+            uint32_t batch[BATCH_SIZE];
+            for (size_t i = 0; i < operationsPerThread; i += BATCH_SIZE) {
+                for (size_t j = 0; j < BATCH_SIZE; ++j) {
+                    batch[j] = pool.allocate();
+                }
+                for (size_t j = 0; j < BATCH_SIZE; ++j) {
+                    if (batch[j] != Pool::INVALID_INDEX) {
+                        pool.free(batch[j]);
+                    }
+                }
+            }
+        });
+
+        for (uint32_t index : busy) {
+            pool.free(index);
+        }
+
+        printResult(name, numThreads, operationsPerThread * numThreads, seconds);
+    }
+}
+
+} // namespace
+
+void runJobSystemBenchmarks()
+{
+    std::printf("Job pool allocation (alloc + free pairs)\n");
+    benchmarkAllocation<LinearScanPool>("LinearScanPool (empty pool)", 0.0f, 1 << 18);
+    benchmarkAllocation<JobFreeList>("JobFreeList (empty pool)", 0.0f, 1 << 18);
+    // The scan is several orders of magnitude slower here, keep the run short
+    benchmarkAllocation<LinearScanPool>("LinearScanPool (90% busy pool)", 0.9f, 1 << 12);
+    benchmarkAllocation<JobFreeList>("JobFreeList (90% busy pool)", 0.9f, 1 << 18);
+}
+
+} // namespace benchmark
@@ -0,0 +1,7 @@
+#include "Benchmark.h"
+
+int main(int, char**)
+{
+    benchmark::runJobSystemBenchmarks();
+    return 0;
+}
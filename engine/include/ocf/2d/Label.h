@@ -1,5 +1,6 @@
 #pragma once
 #include "ocf/2d/Node2D.h"
+#include "ocf/base/PoolAllocated.h"
 #include "ocf/base/Types.h"
 #include "ocf/base/Macros.h"
 #include "ocf/renderer/QuadCommand.h"
@@ -13,7 +14,7 @@ namespace ocf {
 class Font;
 class FontAtlas;
 
-class Label : public Node2D {
+class Label : public Node2D, public PoolAllocated<Label> {
 public:
     enum class LabelType {
         BMFONT,
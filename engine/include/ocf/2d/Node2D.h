@@ -56,6 +56,7 @@ protected:
     bool m_ignoreAnchorPointForPosition;
     mutable bool m_transformDirty;
     bool m_transformUpdated;
+    bool m_modelViewUpdated;    //!< m_modelVewTransform changed on the last visit
     bool m_contentSizeDirty;
 };
 
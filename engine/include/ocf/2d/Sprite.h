@@ -1,5 +1,6 @@
 #pragma once
 #include "ocf/2d/Node2D.h"
+#include "ocf/base/PoolAllocated.h"
 #include "ocf/base/Types.h"
 #include "ocf/math/Rect.h"
 #include "ocf/renderer/TrianglesCommand.h"
@@ -12,7 +13,7 @@ class Material;
 /**
  * @brief Sprite is 2D image (Texture) node.
  */
-class Sprite : public Node2D {
+class Sprite : public Node2D, public PoolAllocated<Sprite> {
 public:
     /** Create sprite */
     static Sprite* create();
@@ -1,10 +1,11 @@
 #pragma once
 #include "ocf/3d/Node3D.h"
 #include "ocf/3d/Mesh.h"
+#include "ocf/base/PoolAllocated.h"
 
 namespace ocf {
 
-class MeshInstance3D : public Node3D {
+class MeshInstance3D : public Node3D, public PoolAllocated<MeshInstance3D> {
 public:
     static MeshInstance3D* create(std::string_view fileName);
 
@@ -0,0 +1,57 @@
+// SPDX - License - Identifier : MIT
+#pragma once
+#include <mutex>
+#include <vector>
+
+namespace ocf {
+
+class Object;
+
+/**
+ * @brief Releases objects at the end of the frame
+ *
+ * Object::autorelease() retains an object and adds it here. The engine calls
+ * drain() once per frame, which releases every object added since the last
+ * drain. Objects may be added from any thread.
+ */
+class AutoreleasePool {
+public:
+    static AutoreleasePool& getInstance();
+
+    ~AutoreleasePool();
+
+    // Non-copyable
+    AutoreleasePool(const AutoreleasePool&) = delete;
+    AutoreleasePool& operator=(const AutoreleasePool&) = delete;
+
+    /**
+     * @brief Add an object to release on the next drain
+     *
+     * The pool takes over one reference of the object.
+     *
+     * @param object Object to release
+     */
+    void addObject(Object* object);
+
+    /**
+     * @brief Release every object in the pool
+     *
+     * Objects autoreleased while draining are released on the next drain.
+     * Must be called from one thread only, usually the main thread.
+     */
+    void drain();
+
+    /**
+     * @brief Get the number of objects waiting for the next drain
+     */
+    size_t getObjectCount() const;
+
+private:
+    AutoreleasePool() = default;
+
+    mutable std::mutex m_mutex;
+    std::vector<Object*> m_objects;
+    std::vector<Object*> m_draining; // Kept to reuse its capacity
+};
+
+} // namespace ocf
@@ -6,6 +6,7 @@
 namespace ocf {
 
 class EventDispatcher;
+class FrameAllocator;
 class Label;
 class RenderView;
 class Renderer;
@@ -14,6 +15,9 @@ class TextureManager;
 namespace backend {
 class Driver;
 }
+namespace job {
+struct JobSystemConfig;
+}
 
 /**
  * @brief Engine class that manages the main loop, scenes, and rendering.
@@ -24,6 +28,15 @@ public:
 
     static void destroyInstance();
 
+    /**
+     * @brief Set the job system configuration used when the engine is created
+     *
+     * Must be called before the first call to getInstance().
+     *
+     * @param config Worker count, thread topology and pool size of the job system
+     */
+    static void setJobSystemConfig(const job::JobSystemConfig& config);
+
     void mainLoop();
 
     void exit();
@@ -52,6 +65,13 @@ public:
 
     EventDispatcher* getEventDispatcher() const { return m_eventDispatcher; }
 
+    /**
+     * @brief Get the allocator for transient data
+     *
+     * Blocks stay valid during the frame they were allocated in and the next one.
+     */
+    FrameAllocator* getFrameAllocator() const { return m_frameAllocator; }
+
 private:
     Engine();
     ~Engine();
@@ -82,6 +102,7 @@ private:
 
     TextureManager* m_textureManager = nullptr;
     EventDispatcher* m_eventDispatcher = nullptr;
+    FrameAllocator* m_frameAllocator = nullptr;
 
     float m_deltaTime = 0.0f;
     std::chrono::steady_clock::time_point m_lastUpdate;
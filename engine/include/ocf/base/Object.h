@@ -1,13 +1,25 @@
 // SPDX - License - Identifier : MIT
 #pragma once
+#include <atomic>
 
 namespace ocf {
 
+/**
+ * @brief Base class of reference counted engine objects
+ *
+ * The reference count starts at 0 and the object is deleted when release()
+ * brings it back to 0. Retaining and releasing are atomic, so an object may be
+ * shared between threads, e.g. created on a job worker.
+ */
 class Object {
 public:
     Object();
     virtual ~Object();
 
+    // Non-copyable, the ID and the reference count belong to one object
+    Object(const Object&) = delete;
+    Object& operator=(const Object&) = delete;
+
     /**
      * @brief Gets the unique identifier for the object.
      * @return The unique identifier for the object.
@@ -26,15 +38,26 @@ public:
      */
     void release();
 
+    /**
+     * @brief  Retains the object until the end of the current frame.
+     *
+     * The object is added to the AutoreleasePool, which releases it once the
+     * frame is over. An object that nobody else retained by then is destroyed.
+     */
+    void autorelease();
+
     /**
      * @brief  Gets the current reference count of the object.
      * @return The current reference count.
      */
-    void autorelease();
+    unsigned int getReferenceCount() const noexcept
+    {
+        return m_referenceCount.load(std::memory_order_relaxed);
+    }
 
 private:
-    unsigned int m_id;              //!< Object ID
-    unsigned int m_referenceCount;  //!< Reference count
+    unsigned int m_id;                              //!< Object ID
+    std::atomic<unsigned int> m_referenceCount{0};  //!< Reference count
 };
 
 } // namespace ocf
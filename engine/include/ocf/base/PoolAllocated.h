@@ -0,0 +1,86 @@
+// SPDX - License - Identifier : MIT
+#pragma once
+#include "ocf/core/Allocator.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace ocf {
+
+/**
+ * @brief Allocates the instances of a class from a pool of its own
+ *
+ * Deriving from PoolAllocated<T> gives T class-specific operator new and
+ * delete that use a GrowingMemoryPool shared by every instance of T. Creating
+ * and destroying many instances (e.g. sprites used as particles) then doesn't
+ * go through the global heap, and the instances end up next to each other.
+ *
+ * Classes derived from T are larger than T and are allocated from the heap.
+ *
+ * Usage:
+ * @code
+ * class Sprite : public Node2D, public PoolAllocated<Sprite> { ... };
+ * @endcode
+ *
+ * @tparam T Class whose instances are pooled
+ */
+template <typename T>
+class PoolAllocated {
+public:
+    static void* operator new(size_t size)
+    {
+        if (size != sizeof(T)) {
+            return ::operator new(size);
+        }
+
+        Pool& pool = getPool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        return pool.blocks.alloc();
+    }
+
+    static void operator delete(void* p, size_t size) noexcept
+    {
+        if (p == nullptr) {
+            return;
+        }
+        if (size != sizeof(T)) {
+            ::operator delete(p);
+            return;
+        }
+
+        Pool& pool = getPool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.blocks.free(p);
+    }
+
+    /**
+     * @brief Get the number of instances the pool can hold without growing
+     */
+    static size_t getPoolCapacity()
+    {
+        Pool& pool = getPool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        return pool.blocks.getCapacity();
+    }
+
+protected:
+    PoolAllocated() = default;
+    ~PoolAllocated() = default;
+
+private:
+    struct Pool {
+        static constexpr size_t ALIGNMENT = std::max(alignof(T), alignof(std::max_align_t));
+
+        std::mutex mutex;
+        GrowingMemoryPool<sizeof(T), ALIGNMENT> blocks;
+    };
+
+    static Pool& getPool()
+    {
+        // Never destroyed, instances may outlive static destruction
+        static Pool* pool = new Pool();
+        return *pool;
+    }
+};
+
+} // namespace ocf
@@ -1,21 +1,17 @@
 #pragma once
 #include "ocf/base/Object.h"
-#include <atomic>
 
 namespace ocf {
 
+/**
+ * @brief Base class of objects held by Ref
+ *
+ * The reference count is the one of Object.
+ */
 class RefCounted : public Object {
 public:
     RefCounted();
     ~RefCounted();
-
-    bool retain();
-    bool release();
-
-    uint32_t getReferenceCount() const noexcept { return m_referenceCount; }
-
-private:
-    mutable std::atomic<uint32_t> m_referenceCount = 0;
 };
 
 template<typename T>
@@ -51,6 +47,7 @@ public:
         if (m_reference == rhs.m_reference) {
             return;
         }
+        unreference();
         m_reference = rhs.m_reference;
         reference();
     }
@@ -2,8 +2,14 @@
 #include <assert.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <atomic>
 #include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace ocf {
 
@@ -124,9 +130,89 @@ private:
     void* m_end;
 };
 
+/**
+ * @brief Lock-free free list, safe to use from several threads
+ *
+ * The head packs the offset of the first node with a tag that changes on
+ * every update, so a compare-exchange fails if the head was popped and pushed
+ * back in between (ABA problem).
+ */
+class AtomicFreeList {
+public:
+    struct Node {
+        std::atomic<Node*> next;
+    };
+
+    AtomicFreeList() noexcept = default;
+    AtomicFreeList(void* begin, void* end, size_t elementSize, size_t alignment, size_t offset);
+    AtomicFreeList(const AtomicFreeList& rhs) = delete;
+    AtomicFreeList& operator=(const AtomicFreeList& rhs) = delete;
+
+    void* pop() noexcept
+    {
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        while (getOffset(head) != EMPTY) {
+            Node* const node = getNode(head);
+            // The node may be popped and modified by another thread meanwhile,
+            // the tag makes the exchange fail in that case
+            Node* const next = node->next.load(std::memory_order_relaxed);
+            const uint64_t newHead = pack(next ? getOffset(next) : EMPTY, getTag(head) + 1);
+            if (m_head.compare_exchange_weak(head, newHead, std::memory_order_acquire,
+                                             std::memory_order_acquire)) {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    void push(void* p) noexcept
+    {
+        assert(p >= m_begin && p < m_end);
+        Node* const node = static_cast<Node*>(p);
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        uint64_t newHead;
+        do {
+            node->next.store(getOffset(head) != EMPTY ? getNode(head) : nullptr,
+                             std::memory_order_relaxed);
+            newHead = pack(getOffset(node), getTag(head) + 1);
+        } while (!m_head.compare_exchange_weak(head, newHead, std::memory_order_release,
+                                               std::memory_order_relaxed));
+    }
+
+    void* begin() const { return m_begin; }
+    void* end() const { return m_end; }
+
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    static constexpr uint64_t pack(uint32_t offset, uint32_t tag)
+    {
+        return (uint64_t(tag) << 32) | offset;
+    }
+    static uint32_t getOffset(uint64_t head) { return uint32_t(head); }
+    static uint32_t getTag(uint64_t head) { return uint32_t(head >> 32); }
+
+    uint32_t getOffset(const Node* node) const
+    {
+        return uint32_t(uintptr_t(node) - uintptr_t(m_begin));
+    }
+    Node* getNode(uint64_t head) const
+    {
+        return pointermath::add(static_cast<Node*>(m_begin), getOffset(head));
+    }
+
+    static uint64_t init(void* begin, void* end, size_t elementSize, size_t alignment,
+                         size_t offset);
+
+    std::atomic<uint64_t> m_head{pack(EMPTY, 0)};
+    void* m_begin = nullptr;
+    void* m_end = nullptr;
+};
+
 template <size_t ELEMENT_SIZE,
           size_t ALIGNMENT = alignof(std::max_align_t),
-          size_t OFFSET = 0 >
+          size_t OFFSET = 0,
+          typename FREELIST = FreeList>
 class MemoryPool {
 public:
     MemoryPool() = default;
@@ -172,11 +258,486 @@ public:
     constexpr size_t getSize() const { return ELEMENT_SIZE; }
 
 private:
-    FreeList m_freeList;
+    FREELIST m_freeList;
+};
+
+/**
+ * @brief MemoryPool that can be used from several threads at once
+ */
+template <size_t ELEMENT_SIZE,
+          size_t ALIGNMENT = alignof(std::max_align_t),
+          size_t OFFSET = 0>
+using AtomicMemoryPool = MemoryPool<ELEMENT_SIZE, ALIGNMENT, OFFSET, AtomicFreeList>;
+
+namespace threadcache {
+
+/**
+ * @brief Maximum number of threads that get their own cache in a ThreadCachedMemoryPool
+ */
+constexpr uint32_t MAX_THREADS = 64;
+
+/**
+ * @brief Get the index of the calling thread's cache
+ *
+ * Indices are handed out on first use and released when the thread exits,
+ * after the caches registered with registerCache() were flushed for it. A
+ * thread that found no free index keeps MAX_THREADS until it exits.
+ *
+ * @return Index of the thread, MAX_THREADS if it has no cache
+ */
+uint32_t getThreadIndex() noexcept;
+
+/**
+ * @brief Register a cache to flush for each thread that exits
+ *
+ * @param cache Cache passed back to flush
+ * @param flush Function returning the blocks cached for a thread index
+ */
+void registerCache(void* cache, void (*flush)(void* cache, uint32_t index));
+
+/**
+ * @brief Unregister a cache, it's no longer flushed once this returns
+ */
+void unregisterCache(void* cache);
+
+} // namespace threadcache
+
+/**
+ * @brief Thread-safe memory pool with per-thread caches
+ *
+ * Each thread keeps up to MAGAZINE_SIZE free blocks in a magazine of its own,
+ * so most allocations and frees touch no shared state. An empty magazine is
+ * refilled with half of its capacity from a shared AtomicFreeList, a full one
+ * returns half of its blocks.
+ *
+ * Blocks cached by a thread are only available to other threads after it
+ * calls flushThreadCache() or exits. Threads beyond threadcache::MAX_THREADS
+ * use the shared free list directly.
+ */
+template <size_t ELEMENT_SIZE,
+          size_t ALIGNMENT = alignof(std::max_align_t),
+          size_t OFFSET = 0,
+          size_t MAGAZINE_SIZE = 32>
+class ThreadCachedMemoryPool {
+    static_assert(MAGAZINE_SIZE >= 2, "MAGAZINE_SIZE must be at least 2");
+
+public:
+    ThreadCachedMemoryPool() = default;
+
+    ~ThreadCachedMemoryPool()
+    {
+        if (m_magazines) {
+            threadcache::unregisterCache(this);
+        }
+    }
+
+    // non-copyable
+    ThreadCachedMemoryPool(const ThreadCachedMemoryPool&) = delete;
+    ThreadCachedMemoryPool& operator=(const ThreadCachedMemoryPool&) = delete;
+
+    ThreadCachedMemoryPool(void* begin, void* end)
+        : m_freeList(begin, end, ELEMENT_SIZE, ALIGNMENT, OFFSET)
+        , m_magazines(std::make_unique<Magazine[]>(threadcache::MAX_THREADS))
+    {
+        threadcache::registerCache(this, &flushMagazine);
+    }
+
+    ThreadCachedMemoryPool(void* begin, size_t size)
+        : ThreadCachedMemoryPool(begin, static_cast<char*>(begin) + size)
+    {
+    }
+
+    template <typename AREA>
+    ThreadCachedMemoryPool(const AREA& area)
+        : ThreadCachedMemoryPool(area.begin(), area.end())
+    {
+    }
+
+    void* alloc(size_t size = ELEMENT_SIZE, size_t alignment = ALIGNMENT, size_t offset = OFFSET)
+    {
+        assert(size <= ELEMENT_SIZE);
+        assert(alignment <= ALIGNMENT);
+        assert(offset == OFFSET);
+
+        Magazine* magazine = getMagazine();
+        if (!magazine) {
+            return m_freeList.pop();
+        }
+        if (magazine->count == 0) {
+            while (magazine->count < MAGAZINE_SIZE / 2) {
+                void* p = m_freeList.pop();
+                if (!p) {
+                    break;
+                }
+                magazine->blocks[magazine->count++] = p;
+            }
+            if (magazine->count == 0) {
+                return nullptr;
+            }
+        }
+        return magazine->blocks[--magazine->count];
+    }
+
+    void free(void* p, size_t = ELEMENT_SIZE)
+    {
+        Magazine* magazine = getMagazine();
+        if (!magazine) {
+            m_freeList.push(p);
+            return;
+        }
+        if (magazine->count == MAGAZINE_SIZE) {
+            while (magazine->count > MAGAZINE_SIZE / 2) {
+                m_freeList.push(magazine->blocks[--magazine->count]);
+            }
+        }
+        magazine->blocks[magazine->count++] = p;
+    }
+
+    /**
+     * @brief Return the blocks cached by the calling thread to the shared list
+     */
+    void flushThreadCache()
+    {
+        Magazine* magazine = getMagazine();
+        if (magazine) {
+            flushMagazine(*magazine);
+        }
+    }
+
+    constexpr size_t getSize() const { return ELEMENT_SIZE; }
+
+private:
+    struct alignas(64) Magazine {
+        size_t count = 0;
+        void* blocks[MAGAZINE_SIZE];
+    };
+
+    Magazine* getMagazine() const
+    {
+        uint32_t index = threadcache::getThreadIndex();
+        return index < threadcache::MAX_THREADS ? &m_magazines[index] : nullptr;
+    }
+
+    void flushMagazine(Magazine& magazine)
+    {
+        while (magazine.count > 0) {
+            m_freeList.push(magazine.blocks[--magazine.count]);
+        }
+    }
+
+    // Called by the exiting thread that owns the magazine
+    static void flushMagazine(void* pool, uint32_t index)
+    {
+        auto* self = static_cast<ThreadCachedMemoryPool*>(pool);
+        self->flushMagazine(self->m_magazines[index]);
+    }
+
+    AtomicFreeList m_freeList;
+    std::unique_ptr<Magazine[]> m_magazines;
+};
+
+/**
+ * @brief MemoryPool that grows with the number of blocks in use
+ *
+ * Blocks come from chunks allocated on the heap, each managed by a MemoryPool.
+ * When every chunk is exhausted a new one, twice as large as the previous one,
+ * is added. Chunks are only released with the pool, so blocks of the same
+ * pool stay close to each other in memory.
+ *
+ * Not thread-safe.
+ */
+template <size_t ELEMENT_SIZE,
+          size_t ALIGNMENT = alignof(std::max_align_t)>
+class GrowingMemoryPool {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param firstChunkCount Number of blocks of the first chunk
+     */
+    explicit GrowingMemoryPool(size_t firstChunkCount = 64)
+        : m_nextChunkCount(firstChunkCount)
+    {
+        assert(firstChunkCount > 0);
+    }
+
+    ~GrowingMemoryPool() = default;
+
+    // non-copyable
+    GrowingMemoryPool(const GrowingMemoryPool&) = delete;
+    GrowingMemoryPool& operator=(const GrowingMemoryPool&) = delete;
+
+    void* alloc()
+    {
+        void* p = m_chunks.empty() ? nullptr : m_chunks[m_available]->pool.alloc();
+        if (p) {
+            return p;
+        }
+
+        // The hinted chunk is exhausted, look for another one with free blocks
+        for (size_t i = 0; i < m_chunks.size(); ++i) {
+            p = m_chunks[i]->pool.alloc();
+            if (p) {
+                m_available = i;
+                return p;
+            }
+        }
+
+        grow();
+        return m_chunks[m_available]->pool.alloc();
+    }
+
+    void free(void* p)
+    {
+        // There are few chunks, their sizes double
+        for (size_t i = 0; i < m_chunks.size(); ++i) {
+            Chunk& chunk = *m_chunks[i];
+            if (p >= chunk.area.begin() && p < chunk.area.end()) {
+                chunk.pool.free(p);
+                m_available = i;
+                return;
+            }
+        }
+        assert(false && "block not allocated from this pool");
+    }
+
+    /**
+     * @brief Get the total number of blocks of all chunks
+     */
+    size_t getCapacity() const { return m_capacity; }
+
+    size_t getChunkCount() const { return m_chunks.size(); }
+
+    constexpr size_t getSize() const { return ELEMENT_SIZE; }
+
+private:
+    struct Chunk {
+        explicit Chunk(size_t size)
+            : area(size)
+            , pool(area)
+        {
+        }
+
+        AreaPolicy::HeapArea area;
+        MemoryPool<ELEMENT_SIZE, ALIGNMENT> pool;
+    };
+
+    void grow()
+    {
+        // Room for the blocks and for aligning the first one
+        const size_t stride = (ELEMENT_SIZE + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        const size_t size = m_nextChunkCount * stride + ALIGNMENT - 1;
+        m_chunks.push_back(std::make_unique<Chunk>(size));
+        m_available = m_chunks.size() - 1;
+        m_capacity += m_nextChunkCount;
+        m_nextChunkCount *= 2;
+    }
+
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    size_t m_available = 0; // Chunk tried first, the last one freed to or grown
+    size_t m_nextChunkCount;
+    size_t m_capacity = 0;
+};
+
+/**
+ * @brief Linear (bump pointer) allocation policy
+ *
+ * Allocating moves a pointer forward, individual frees are no-ops. Memory is
+ * reclaimed all at once with reset(), or back to a point saved with
+ * getCurrent() using rewind().
+ */
+class BumpAllocator {
+public:
+    BumpAllocator() = default;
+
+    BumpAllocator(void* begin, void* end)
+        : m_begin(begin)
+        , m_size(uintptr_t(end) - uintptr_t(begin))
+    {
+    }
+
+    template <typename AREA>
+    explicit BumpAllocator(const AREA& area)
+        : BumpAllocator(area.begin(), area.end())
+    {
+    }
+
+    // non-copyable
+    BumpAllocator(const BumpAllocator&) = delete;
+    BumpAllocator& operator=(const BumpAllocator&) = delete;
+
+    // movable
+    BumpAllocator(BumpAllocator&& rhs) noexcept { swap(rhs); }
+    BumpAllocator& operator=(BumpAllocator&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Allocate a block
+     *
+     * @param size Size of the block in bytes
+     * @param alignment Alignment of the returned pointer (must be a power of two)
+     * @param offset Bytes reserved in front of the aligned pointer
+     * @return Pointer to the block, or nullptr if the area is exhausted
+     */
+    void* alloc(size_t size, size_t alignment = alignof(std::max_align_t), size_t offset = 0)
+    {
+        void* const p = pointermath::align(getCurrent(), alignment, offset);
+        void* const c = pointermath::add(p, size);
+        if (uintptr_t(c) > uintptr_t(end())) {
+            return nullptr;
+        }
+        m_current = uintptr_t(c) - uintptr_t(m_begin);
+        return p;
+    }
+
+    // Individual blocks are never freed
+    void free(void*) {}
+    void free(void*, size_t) {}
+
+    /**
+     * @brief Get the current allocation position, to be passed to rewind() later
+     */
+    void* getCurrent() const { return pointermath::add(m_begin, m_current); }
+
+    /**
+     * @brief Free everything allocated after a position returned by getCurrent()
+     */
+    void rewind(void* p)
+    {
+        assert(p >= m_begin && p <= end());
+        m_current = uintptr_t(p) - uintptr_t(m_begin);
+    }
+
+    /**
+     * @brief Free everything
+     */
+    void reset() { m_current = 0; }
+
+    size_t getAllocatedSize() const { return m_current; }
+    size_t getAvailableSize() const { return m_size - m_current; }
+    size_t getSize() const { return m_size; }
+
+private:
+    void* end() const { return pointermath::add(m_begin, m_size); }
+
+    void swap(BumpAllocator& rhs) noexcept
+    {
+        std::swap(m_begin, rhs.m_begin);
+        std::swap(m_size, rhs.m_size);
+        std::swap(m_current, rhs.m_current);
+    }
+
+    void* m_begin = nullptr;
+    size_t m_size = 0;
+    size_t m_current = 0;
+};
+
+/**
+ * @brief Allocation statistics of an allocator, or of all allocators sharing a name
+ */
+struct AllocatorStats {
+    const char* name = nullptr;
+    size_t capacity = 0;          ///< Size of the area in bytes
+    size_t liveCount = 0;         ///< Blocks currently allocated
+    size_t liveBytes = 0;         ///< Bytes currently allocated
+    size_t peakCount = 0;         ///< High-water mark of liveCount
+    size_t peakBytes = 0;         ///< High-water mark of liveBytes
+    uint64_t allocationCount = 0; ///< Successful allocations since creation
+    uint64_t failureCount = 0;    ///< Allocations that returned nullptr
+};
+
+namespace TrackingPolicy {
+
+/**
+ * @brief No tracking, compiles to nothing
+ */
+class Untracked {
+public:
+    Untracked() noexcept = default;
+    Untracked(const char*, void*, size_t) noexcept {}
+
+    void onAlloc(void*, size_t) noexcept {}
+    void onFailure(size_t) noexcept {}
+    void onFree(void*) noexcept {}
+    void onRewind(void*) noexcept {}
+    void onReset() noexcept {}
+};
+
+/**
+ * @brief Records the statistics of an allocator and registers it with AllocatorTracker
+ *
+ * The size of every live block is kept, so this is meant for profiling
+ * builds. Thread-safe.
+ */
+class Tracked {
+public:
+    Tracked(const char* name, void* base, size_t size);
+    ~Tracked();
+
+    Tracked(const Tracked&) = delete;
+    Tracked& operator=(const Tracked&) = delete;
+
+    void onAlloc(void* p, size_t size);
+    void onFailure(size_t size);
+    void onFree(void* p);
+    void onRewind(void* p);
+    void onReset();
+
+    AllocatorStats getStats() const;
+
+private:
+    void release(std::unordered_map<void*, size_t>::iterator it);
+
+    mutable std::mutex m_lock;
+    std::unordered_map<void*, size_t> m_sizes;
+    AllocatorStats m_stats;
+};
+
+#if defined(OCF_ALLOCATOR_TRACKING) && OCF_ALLOCATOR_TRACKING
+using Default = Tracked;
+#else
+using Default = Untracked;
+#endif
+
+} // namespace TrackingPolicy
+
+/**
+ * @brief Registry of the allocators using TrackingPolicy::Tracked
+ *
+ * Tracking is enabled for every LinearAllocator by configuring with
+ * OCF_ENABLE_ALLOCATOR_TRACKING=ON.
+ */
+class AllocatorTracker {
+public:
+    /**
+     * @brief Get the statistics of the tracked allocators
+     *
+     * Allocators with the same name are added together.
+     *
+     * @return One entry per allocator name, sorted by name
+     */
+    static std::vector<AllocatorStats> getStats();
+
+    /**
+     * @brief Log the statistics of the tracked allocators
+     */
+    static void logStats();
+
+private:
+    friend class TrackingPolicy::Tracked;
+
+    static void add(const TrackingPolicy::Tracked* tracked);
+    static void remove(const TrackingPolicy::Tracked* tracked);
 };
 
 template <typename Allocator,
-          typename AreaPolicy = AreaPolicy::HeapArea>
+          typename AreaPolicy = AreaPolicy::HeapArea,
+          typename TrackingPolicy = TrackingPolicy::Default>
 class LinearAllocator {
 public:
     template <typename... ARGS>
@@ -184,28 +745,30 @@ public:
         : m_name(name)
         , m_area(size)
         , m_allocator(m_area, std::forward<ARGS>...)
+        , m_tracking(name, m_area.data(), m_area.size())
     {
     }
 
     void* alloc()
     {
-        return m_allocator.alloc();
+        return track(m_allocator.alloc(), m_allocator.getSize());
     }
 
     void* alloc(size_t size, size_t alignment = alignof(std::max_align_t), size_t offset = 0)
     {
-        return m_allocator.alloc(size, alignment, offset);
+        return track(m_allocator.alloc(size, alignment, offset), size);
     }
 
     template <typename... ARGS>
     void* alloc(size_t size, size_t alignment, size_t offset, ARGS&&... args)
     {
-        return m_allocator.alloc(size, alignment, offset, std::forward<ARGS>(args)...);
+        return track(m_allocator.alloc(size, alignment, offset, std::forward<ARGS>(args)...), size);
     }
 
     void free(void* p)
     {
         if (p) {
+            m_tracking.onFree(p);
             m_allocator.free(p);
         }
     }
@@ -214,20 +777,116 @@ public:
     void free(void* p, size_t size, ARGS&& ... args)
     {
         if (p) {
+            m_tracking.onFree(p);
             m_allocator.free(p, size, std::forward<ARGS>(args)...);
         }
     }
 
+    // Only available with a policy supporting them, e.g. BumpAllocator
+    void* getCurrent() const { return m_allocator.getCurrent(); }
+
+    void rewind(void* p)
+    {
+        m_tracking.onRewind(p);
+        m_allocator.rewind(p);
+    }
+
+    void reset()
+    {
+        m_tracking.onReset();
+        m_allocator.reset();
+    }
+
+    const char* getName() const { return m_name; }
+
     AreaPolicy& getArea() { return m_area; }
     const AreaPolicy& getArea() const { return m_area; }
 
     Allocator& getAllocator() { return m_allocator; }
     const Allocator& getAllocator() const { return m_allocator; }
 
+    TrackingPolicy& getTracking() { return m_tracking; }
+    const TrackingPolicy& getTracking() const { return m_tracking; }
+
 private:
+    void* track(void* p, size_t size)
+    {
+        if (p) {
+            m_tracking.onAlloc(p, size);
+        }
+        else {
+            m_tracking.onFailure(size);
+        }
+        return p;
+    }
+
     const char* m_name;
     AreaPolicy m_area;
     Allocator m_allocator;
+    TrackingPolicy m_tracking;
+};
+
+/**
+ * @brief Adaptor to use an allocator with STL containers
+ *
+ * The allocator must provide alloc(size, alignment) and free(p, size). It is
+ * referenced, not owned, and must outlive the containers using it.
+ *
+ * @code
+ * std::vector<int, STLAllocator<int, FrameAllocator>> values(frameAllocator);
+ * @endcode
+ */
+template <typename T, typename ARENA>
+class STLAllocator {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    template <typename U>
+    struct rebind {
+        using other = STLAllocator<U, ARENA>;
+    };
+
+    STLAllocator(ARENA& arena) noexcept
+        : m_arena(&arena)
+    {
+    }
+
+    template <typename U>
+    STLAllocator(const STLAllocator<U, ARENA>& rhs) noexcept
+        : m_arena(rhs.m_arena)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        void* p = m_arena->alloc(n * sizeof(T), alignof(T));
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) { m_arena->free(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const STLAllocator<U, ARENA>& rhs) const noexcept
+    {
+        return m_arena == rhs.m_arena;
+    }
+
+    template <typename U>
+    bool operator!=(const STLAllocator<U, ARENA>& rhs) const noexcept
+    {
+        return !operator==(rhs);
+    }
+
+private:
+    template <typename U, typename A>
+    friend class STLAllocator;
+
+    ARENA* m_arena;
 };
 
 } // namespace ocf
@@ -0,0 +1,110 @@
+#pragma once
+#include "ocf/core/Allocator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ocf {
+
+/**
+ * @brief Multi-buffered linear allocator for transient frame data
+ *
+ * Each frame allocates from its own BumpAllocator, and nextFrame() moves on
+ * to the next one and resets it. A block therefore stays valid for
+ * getFrameCount() frames, which lets data produced in one frame be consumed
+ * in the next one (e.g. by the renderer) without copying.
+ *
+ * When a frame's area is exhausted, allocations fall back to the heap and are
+ * released when the frame's area is reset.
+ *
+ * Not thread-safe, meant to be used from the main thread.
+ */
+class FrameAllocator {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param name Name of the allocator, used in log messages
+     * @param sizePerFrame Size of the area of each frame in bytes
+     * @param frameCount Number of frames a block stays valid (2 = double buffering)
+     */
+    FrameAllocator(const char* name, size_t sizePerFrame, uint32_t frameCount = 2);
+    ~FrameAllocator();
+
+    // Non-copyable
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    /**
+     * @brief Allocate a block valid until the current frame's area is reset
+     *
+     * @param size Size of the block in bytes
+     * @param alignment Alignment of the returned pointer (must be a power of two)
+     * @return Pointer to the block
+     */
+    void* alloc(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // Blocks are released with their frame
+    void free(void*) {}
+    void free(void*, size_t) {}
+
+    /**
+     * @brief Start a new frame
+     *
+     * Every block allocated getFrameCount() frames ago becomes invalid.
+     */
+    void nextFrame();
+
+    /**
+     * @brief Get the number of bytes allocated from the current frame's area
+     */
+    size_t getAllocatedSize() const;
+
+    /**
+     * @brief Get the number of bytes allocated from the heap in the current frame
+     */
+    size_t getOverflowSize() const { return m_frames[m_frameIndex].overflowSize; }
+
+    /**
+     * @brief Get the size of each frame's area in bytes
+     */
+    size_t getSizePerFrame() const { return m_sizePerFrame; }
+
+    uint32_t getFrameCount() const { return static_cast<uint32_t>(m_frames.size()); }
+
+    uint32_t getFrameIndex() const { return m_frameIndex; }
+
+    const char* getName() const { return m_name; }
+
+private:
+    using Arena = LinearAllocator<BumpAllocator>;
+
+    struct Overflow {
+        void* block;
+        size_t alignment;
+    };
+
+    struct Frame {
+        std::unique_ptr<Arena> arena;
+        std::vector<Overflow> overflow;
+        size_t overflowSize = 0;
+    };
+
+    void releaseOverflow(Frame& frame);
+
+    const char* m_name;
+    size_t m_sizePerFrame;
+    std::vector<Frame> m_frames;
+    uint32_t m_frameIndex = 0;
+    bool m_overflowReported = false;
+};
+
+/**
+ * @brief std::vector allocating from a FrameAllocator
+ */
+template <typename T>
+using FrameVector = std::vector<T, STLAllocator<T, FrameAllocator>>;
+
+} // namespace ocf
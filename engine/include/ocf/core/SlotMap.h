@@ -0,0 +1,240 @@
+#pragma once
+#include <assert.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace ocf {
+
+/**
+ * @brief Container with stable keys and contiguous storage
+ *
+ * Values are stored densely in a vector, so iterating over them is as fast as
+ * iterating over a std::vector. Each value is reached through a key holding the
+ * index of a slot and the slot's generation. Erasing a value moves the last
+ * value into its place and increments the generation of its slot, so keys of
+ * erased values no longer resolve, even once the slot has been reused.
+ *
+ * Insertion, erasure and lookup are O(1). Pointers and iterators to values are
+ * invalidated by insertion and erasure, keys are not.
+ *
+ * A key packs the slot index and the generation into 31 bits, so it also fits
+ * in a non-negative int. Generations wrap after 2^(31 - INDEX_BITS) reuses of
+ * a slot.
+ *
+ * @tparam T Type of the values
+ * @tparam INDEX_BITS Number of bits of the slot index, limits the number of values
+ */
+template <typename T, uint32_t INDEX_BITS = 20>
+class SlotMap {
+    static_assert(INDEX_BITS > 0 && INDEX_BITS < 31, "INDEX_BITS must be in [1, 30]");
+
+public:
+    class Key {
+    public:
+        Key() = default;
+
+        /**
+         * @brief Rebuild a key from the value returned by getId()
+         */
+        static Key fromId(uint32_t id) { return Key(id); }
+
+        uint32_t getId() const { return m_id; }
+
+        /**
+         * @brief Check if the key was returned by a SlotMap
+         *
+         * A valid key may still refer to an erased value, see SlotMap::contains().
+         */
+        bool isValid() const { return m_id != 0; }
+
+        explicit operator bool() const { return isValid(); }
+
+        bool operator==(const Key& rhs) const { return m_id == rhs.m_id; }
+        bool operator!=(const Key& rhs) const { return m_id != rhs.m_id; }
+
+    private:
+        friend class SlotMap;
+
+        explicit Key(uint32_t id)
+            : m_id(id)
+        {
+        }
+
+        Key(uint32_t index, uint32_t generation)
+            : m_id((generation << INDEX_BITS) | index)
+        {
+        }
+
+        uint32_t getIndex() const { return m_id & INDEX_MASK; }
+        uint32_t getGeneration() const { return m_id >> INDEX_BITS; }
+
+        // 0 is never handed out, generations start at 1
+        uint32_t m_id = 0;
+    };
+
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    SlotMap() = default;
+
+    /**
+     * @brief Insert a value
+     *
+     * @return Key of the value
+     */
+    Key insert(const T& value) { return emplace(value); }
+
+    Key insert(T&& value) { return emplace(std::move(value)); }
+
+    /**
+     * @brief Construct a value in place
+     *
+     * @param args Arguments passed to the constructor of T
+     * @return Key of the value
+     */
+    template <typename... ARGS>
+    Key emplace(ARGS&&... args)
+    {
+        uint32_t index;
+        if (m_freeHead != NONE) {
+            index = m_freeHead;
+            m_freeHead = m_slots[index].denseIndex;
+        }
+        else {
+            assert(m_slots.size() < MAX_SIZE);
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.push_back({NONE, 1});
+        }
+
+        Slot& slot = m_slots[index];
+        slot.denseIndex = static_cast<uint32_t>(m_values.size());
+        m_values.emplace_back(std::forward<ARGS>(args)...);
+        m_valueSlots.push_back(index);
+        return Key(index, slot.generation);
+    }
+
+    /**
+     * @brief Erase the value of a key
+     *
+     * The last value is moved into the erased value's place.
+     *
+     * @param key Key of the value
+     * @return true if the key referred to a value
+     */
+    bool erase(Key key)
+    {
+        if (!contains(key)) {
+            return false;
+        }
+
+        const uint32_t index = key.getIndex();
+        Slot& slot = m_slots[index];
+        const uint32_t denseIndex = slot.denseIndex;
+        const uint32_t last = static_cast<uint32_t>(m_values.size()) - 1;
+        if (denseIndex != last) {
+            m_values[denseIndex] = std::move(m_values[last]);
+            m_valueSlots[denseIndex] = m_valueSlots[last];
+            m_slots[m_valueSlots[denseIndex]].denseIndex = denseIndex;
+        }
+        m_values.pop_back();
+        m_valueSlots.pop_back();
+
+        slot.generation = (slot.generation + 1) & GENERATION_MASK;
+        if (slot.generation == 0) {
+            slot.generation = 1;
+        }
+        slot.denseIndex = m_freeHead;
+        m_freeHead = index;
+        return true;
+    }
+
+    /**
+     * @brief Check if a key refers to a value
+     */
+    bool contains(Key key) const
+    {
+        const uint32_t index = key.getIndex();
+        return key.isValid() && index < m_slots.size()
+               && m_slots[index].generation == key.getGeneration();
+    }
+
+    /**
+     * @brief Get the value of a key
+     *
+     * @return Pointer to the value, nullptr if the key was erased
+     */
+    T* get(Key key)
+    {
+        return contains(key) ? &m_values[m_slots[key.getIndex()].denseIndex] : nullptr;
+    }
+
+    const T* get(Key key) const
+    {
+        return contains(key) ? &m_values[m_slots[key.getIndex()].denseIndex] : nullptr;
+    }
+
+    /**
+     * @brief Get the key of the value at a position of the dense storage
+     *
+     * Allows erasing while iterating by position: after erase() the position
+     * holds the former last value.
+     *
+     * @param denseIndex Position in [0, size())
+     */
+    Key getKey(size_t denseIndex) const
+    {
+        const uint32_t index = m_valueSlots[denseIndex];
+        return Key(index, m_slots[index].generation);
+    }
+
+    T& operator[](size_t denseIndex) { return m_values[denseIndex]; }
+    const T& operator[](size_t denseIndex) const { return m_values[denseIndex]; }
+
+    /**
+     * @brief Erase every value, all keys become invalid
+     */
+    void clear()
+    {
+        while (!m_values.empty()) {
+            erase(getKey(m_values.size() - 1));
+        }
+    }
+
+    void reserve(size_t capacity)
+    {
+        m_values.reserve(capacity);
+        m_valueSlots.reserve(capacity);
+        m_slots.reserve(capacity);
+    }
+
+    size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+
+    T* data() { return m_values.data(); }
+    const T* data() const { return m_values.data(); }
+
+    iterator begin() { return m_values.begin(); }
+    iterator end() { return m_values.end(); }
+    const_iterator begin() const { return m_values.begin(); }
+    const_iterator end() const { return m_values.end(); }
+
+private:
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1u;
+    static constexpr uint32_t GENERATION_MASK = (1u << (31 - INDEX_BITS)) - 1u;
+    static constexpr uint32_t MAX_SIZE = INDEX_MASK + 1u;
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Slot {
+        // Position of the value, or the next free slot while the slot is free
+        uint32_t denseIndex;
+        uint32_t generation;
+    };
+
+    std::vector<T> m_values;
+    std::vector<uint32_t> m_valueSlots; // Slot of each value
+    std::vector<Slot> m_slots;
+    uint32_t m_freeHead = NONE;
+};
+
+} // namespace ocf
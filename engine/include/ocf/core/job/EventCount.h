@@ -0,0 +1,101 @@
+#pragma once
+
+#include "ocf/platform/PlatformConfig.h"
+
+#include <atomic>
+#include <cstdint>
+
+#if (OCF_TARGET_PLATFORM != OCF_PLATFORM_LINUX)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace ocf {
+namespace job {
+
+/**
+ * @brief Event count used to park idle worker threads
+ *
+ * A waiter first registers with prepareWait(), checks its condition once
+ * more, then either calls cancelWait() or blocks in commitWait(). Any
+ * notify() issued after prepareWait() releases the waiter, so a condition
+ * that becomes true between the check and the block is never missed.
+ *
+ * Producers only pay for a fence and a load when nobody is parked. On Linux
+ * waiters block on a futex, elsewhere on a condition variable.
+ */
+class EventCount {
+public:
+    using Key = uint32_t;
+
+    EventCount() = default;
+    ~EventCount() = default;
+
+    // Non-copyable
+    EventCount(const EventCount&) = delete;
+    EventCount& operator=(const EventCount&) = delete;
+
+    /**
+     * @brief Register the calling thread as a waiter
+     *
+     * @return Key to pass to commitWait()
+     */
+    Key prepareWait()
+    {
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return m_epoch.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Unregister the calling thread without blocking
+     */
+    void cancelWait() { m_waiters.fetch_sub(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Block until a notification issued after prepareWait()
+     *
+     * @param key Key returned by prepareWait()
+     */
+    void commitWait(Key key);
+
+    /**
+     * @brief Wake up to count waiting threads
+     *
+     * @param count Maximum number of threads to wake up
+     */
+    void notify(uint32_t count = 1)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        wake(count);
+    }
+
+    /**
+     * @brief Wake up all waiting threads
+     */
+    void notifyAll() { notify(UINT32_MAX); }
+
+    /**
+     * @brief Get the number of registered waiters
+     *
+     * @return Approximate number of parked or parking threads
+     */
+    uint32_t getWaiterCount() const { return m_waiters.load(std::memory_order_relaxed); }
+
+private:
+    void wake(uint32_t count);
+
+    alignas(64) std::atomic<uint32_t> m_epoch{0};
+    std::atomic<uint32_t> m_waiters{0};
+
+#if (OCF_TARGET_PLATFORM != OCF_PLATFORM_LINUX)
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+#endif
+};
+
+}  // namespace job
+}  // namespace ocf
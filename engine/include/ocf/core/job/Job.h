@@ -3,7 +3,10 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
-#include <functional>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace ocf {
 namespace job {
@@ -20,6 +23,19 @@ enum class JobPriority : uint8_t {
     Critical = 3
 };
 
+/**
+ * @brief Number of priority levels, used to size per-priority queues
+ */
+constexpr size_t JOB_PRIORITY_COUNT = 4;
+
+/**
+ * @brief Maximum number of continuations a single job can trigger
+ *
+ * The continuations are stored by JobSystem next to the job pool, out of Job.
+ * Larger fan-outs go through intermediate jobs, see TaskGraph.
+ */
+constexpr size_t MAX_JOB_CONTINUATIONS = 6;
+
 /**
  * @brief Handle to a job, used for dependency tracking
  */
@@ -43,11 +59,132 @@ struct JobHandle {
 constexpr JobHandle INVALID_JOB_HANDLE = {0, 0};
 
 /**
- * @brief Function type for job execution
+ * @brief Callable executed by a job
  *
- * @param data User-provided data pointer
+ * A move-only replacement for std::function<void(void*)> that stores the
+ * callable inline, so creating a job never allocates. Callables larger than
+ * STORAGE_SIZE, two pointers, are rejected at compile time; pass larger state
+ * through the job's data pointer instead.
  */
-using JobFunction = std::function<void(void*)>;
+class JobFunction {
+public:
+    static constexpr size_t STORAGE_SIZE = 16;
+    static constexpr size_t STORAGE_ALIGNMENT = alignof(std::max_align_t);
+
+    JobFunction() noexcept = default;
+
+    JobFunction(std::nullptr_t) noexcept {}
+
+    template <typename F,
+              typename Fn = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<Fn, JobFunction> &&
+                                          std::is_invocable_v<Fn&, void*>>>
+    JobFunction(F&& function)
+    {
+        static_assert(sizeof(Fn) <= STORAGE_SIZE,
+                      "Job function is too large, pass its state through the data pointer");
+        static_assert(alignof(Fn) <= STORAGE_ALIGNMENT, "Job function is over-aligned");
+        static_assert(std::is_nothrow_move_constructible_v<Fn>,
+                      "Job function must be nothrow move constructible");
+
+        new (m_storage) Fn(std::forward<F>(function));
+        m_invoke = &invoke<Fn>;
+        if constexpr (!std::is_trivially_copyable_v<Fn> ||
+                      !std::is_trivially_destructible_v<Fn>) {
+            m_manage = &manage<Fn>;
+        }
+    }
+
+    ~JobFunction() { reset(); }
+
+    // Non-copyable
+    JobFunction(const JobFunction&) = delete;
+    JobFunction& operator=(const JobFunction&) = delete;
+
+    // Movable
+    JobFunction(JobFunction&& other) noexcept { moveFrom(other); }
+
+    JobFunction& operator=(JobFunction&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    JobFunction& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    /**
+     * @brief Destroy the stored callable
+     */
+    void reset() noexcept
+    {
+        if (m_manage) {
+            m_manage(Operation::Destroy, m_storage, nullptr);
+        }
+        m_invoke = nullptr;
+        m_manage = nullptr;
+    }
+
+    void operator()(void* data) { m_invoke(m_storage, data); }
+
+    explicit operator bool() const noexcept { return m_invoke != nullptr; }
+
+private:
+    enum class Operation : uint8_t {
+        Move,
+        Destroy
+    };
+
+    using InvokeFunction = void (*)(void* storage, void* data);
+    using ManageFunction = void (*)(Operation operation, void* dst, void* src);
+
+    template <typename Fn>
+    static void invoke(void* storage, void* data)
+    {
+        (*std::launder(static_cast<Fn*>(storage)))(data);
+    }
+
+    template <typename Fn>
+    static void manage(Operation operation, void* dst, void* src)
+    {
+        switch (operation) {
+        case Operation::Move: {
+            Fn* from = std::launder(static_cast<Fn*>(src));
+            new (dst) Fn(std::move(*from));
+            from->~Fn();
+            break;
+        }
+        case Operation::Destroy:
+            std::launder(static_cast<Fn*>(dst))->~Fn();
+            break;
+        }
+    }
+
+    void moveFrom(JobFunction& other) noexcept
+    {
+        if (other.m_manage) {
+            other.m_manage(Operation::Move, m_storage, other.m_storage);
+        }
+        else if (other.m_invoke) {
+            // Trivially copyable callables are relocated bitwise
+            std::memcpy(m_storage, other.m_storage, STORAGE_SIZE);
+        }
+        m_invoke = other.m_invoke;
+        m_manage = other.m_manage;
+        other.m_invoke = nullptr;
+        other.m_manage = nullptr;
+    }
+
+    alignas(STORAGE_ALIGNMENT) unsigned char m_storage[STORAGE_SIZE];
+    InvokeFunction m_invoke = nullptr;
+    ManageFunction m_manage = nullptr;
+};
 
 /**
  * @brief Job structure representing a unit of work
@@ -56,16 +193,21 @@ using JobFunction = std::function<void(void*)>;
  * by worker threads. Each job contains:
  * - An execution function
  * - A data pointer for input/output
- * - Dependency information
+ * - Dependency information (parent, continuations are kept by JobSystem)
  * - Priority level
+ *
+ * A job fits in a single cache line.
  */
 struct alignas(64) Job {
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
     JobFunction function;               ///< The function to execute
     void* data = nullptr;               ///< User data pointer
-    JobPriority priority = JobPriority::Normal;  ///< Job priority
     JobHandle handle;                   ///< Handle to this job
-    JobHandle parent;                   ///< Parent job for hierarchical dependencies
     std::atomic<int32_t> unfinishedJobs{1};      ///< Count of unfinished child jobs + 1 (for self)
+    std::atomic<int32_t> pendingDependencies{1}; ///< Count of unfinished antecedents + 1 (for run)
+    uint32_t parent = NO_PARENT;        ///< Pool index of the parent job
+    JobPriority priority = JobPriority::Normal;  ///< Job priority
 
     Job() = default;
 
@@ -84,10 +226,11 @@ struct alignas(64) Job {
     Job(Job&& other) noexcept
         : function(std::move(other.function))
         , data(other.data)
-        , priority(other.priority)
         , handle(other.handle)
-        , parent(other.parent)
         , unfinishedJobs(other.unfinishedJobs.load(std::memory_order_relaxed))
+        , pendingDependencies(other.pendingDependencies.load(std::memory_order_relaxed))
+        , parent(other.parent)
+        , priority(other.priority)
     {
         other.data = nullptr;
     }
@@ -97,16 +240,20 @@ struct alignas(64) Job {
         if (this != &other) {
             function = std::move(other.function);
             data = other.data;
-            priority = other.priority;
             handle = other.handle;
-            parent = other.parent;
             unfinishedJobs.store(other.unfinishedJobs.load(std::memory_order_relaxed),
                                  std::memory_order_relaxed);
+            pendingDependencies.store(other.pendingDependencies.load(std::memory_order_relaxed),
+                                      std::memory_order_relaxed);
+            parent = other.parent;
+            priority = other.priority;
             other.data = nullptr;
         }
         return *this;
     }
 };
 
+static_assert(sizeof(Job) == 64, "Job should fit in a cache line");
+
 }  // namespace job
 }  // namespace ocf
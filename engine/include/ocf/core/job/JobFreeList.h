@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ocf {
+namespace job {
+
+/**
+ * @brief Lock-free free list of job pool indices
+ *
+ * A Treiber stack over the indices [0, capacity). The head packs the index of
+ * the first free slot with a tag that is incremented on every update, so a
+ * slot that is popped and pushed back between a load and a CAS of another
+ * thread (ABA) is detected and the CAS retried.
+ *
+ * Both allocate() and free() are O(1) and can be called from any thread.
+ */
+class JobFreeList {
+public:
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    JobFreeList() = default;
+
+    explicit JobFreeList(size_t capacity) { reset(capacity); }
+
+    // Non-copyable
+    JobFreeList(const JobFreeList&) = delete;
+    JobFreeList& operator=(const JobFreeList&) = delete;
+
+    /**
+     * @brief Rebuild the list so that all indices are free
+     *
+     * Not thread-safe, must only be called while no other thread uses the list.
+     *
+     * @param capacity Number of indices managed by the list
+     */
+    void reset(size_t capacity)
+    {
+        m_capacity = capacity;
+        m_next = capacity > 0 ? std::make_unique<std::atomic<uint32_t>[]>(capacity) : nullptr;
+        for (size_t i = 0; i < capacity; ++i) {
+            uint32_t next = (i + 1 < capacity) ? static_cast<uint32_t>(i + 1) : INVALID_INDEX;
+            m_next[i].store(next, std::memory_order_relaxed);
+        }
+        m_head.store(pack(capacity > 0 ? 0 : INVALID_INDEX, 0), std::memory_order_release);
+    }
+
+    /**
+     * @brief Pop a free index
+     *
+     * @return A free index, or INVALID_INDEX if the list is exhausted
+     */
+    uint32_t allocate()
+    {
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t index = indexOf(head);
+            if (index == INVALID_INDEX) {
+                return INVALID_INDEX;
+            }
+            // m_next[index] may be stale if another thread popped this index
+            // meanwhile, but then the tag has changed and the CAS fails.
+            uint32_t next = m_next[index].load(std::memory_order_relaxed);
+            uint64_t newHead = pack(next, tagOf(head) + 1);
+            if (m_head.compare_exchange_weak(head, newHead, std::memory_order_acquire,
+                                             std::memory_order_acquire)) {
+                return index;
+            }
+        }
+    }
+
+    /**
+     * @brief Push an index back to the list
+     *
+     * @param index Index previously returned by allocate()
+     */
+    void free(uint32_t index)
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        for (;;) {
+            m_next[index].store(indexOf(head), std::memory_order_relaxed);
+            uint64_t newHead = pack(index, tagOf(head) + 1);
+            if (m_head.compare_exchange_weak(head, newHead, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Get the number of indices managed by the list
+     *
+     * @return Capacity of the list
+     */
+    size_t capacity() const { return m_capacity; }
+
+private:
+    static uint64_t pack(uint32_t index, uint32_t tag)
+    {
+        return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+    static uint32_t indexOf(uint64_t head) { return static_cast<uint32_t>(head); }
+    static uint32_t tagOf(uint64_t head) { return static_cast<uint32_t>(head >> 32); }
+
+    alignas(64) std::atomic<uint64_t> m_head{pack(INVALID_INDEX, 0)};
+    std::unique_ptr<std::atomic<uint32_t>[]> m_next;
+    size_t m_capacity{0};
+};
+
+}  // namespace job
+}  // namespace ocf
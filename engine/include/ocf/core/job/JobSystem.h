@@ -1,15 +1,24 @@
 #pragma once
 
+#include "ocf/core/job/EventCount.h"
 #include "ocf/core/job/Job.h"
+#include "ocf/core/job/JobFreeList.h"
+#include "ocf/core/job/MpmcQueue.h"
 #include "ocf/core/job/Worker.h"
 #include "ocf/core/job/WorkStealingQueue.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <ostream>
+#include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace ocf {
@@ -19,8 +28,16 @@ namespace job {
  * @brief Configuration for the job system
  */
 struct JobSystemConfig {
-    uint32_t numWorkers = 0;  ///< Number of worker threads (0 = auto-detect based on hardware)
+    uint32_t numWorkers = 0;  ///< Number of worker threads (0 = one per available core, minus one)
     size_t maxJobs = 4096;    ///< Maximum number of jobs in the pool
+    uint32_t spinCount = 64;  ///< Times an idle worker looks for work before parking
+    bool pinWorkers = false;  ///< Pin each worker thread to a CPU core, see getAvailableCores()
+    int32_t reservedCore = 0;  ///< Core kept free for the main/render thread when pinning (-1 = none)
+    std::string threadName = "JobWorker";  ///< Worker thread name, followed by the worker ID
+    size_t stackSize = 0;  ///< Worker thread stack size in bytes (0 = platform default)
+    bool enableProfiling = false;  ///< Collect per-worker counters, see getWorkerStats()
+    bool enableTimeline = false;   ///< Record the execution span of every job, see writeChromeTrace()
+    size_t timelineCapacity = 65536;  ///< Maximum number of timeline events kept per worker
 };
 
 /**
@@ -29,8 +46,8 @@ struct JobSystemConfig {
  * The JobSystem manages a pool of worker threads that execute jobs.
  * Key features:
  * - Work stealing for load balancing
- * - Job dependencies (parent-child relationships)
- * - Priority-based scheduling
+ * - Job dependencies (parent-child relationships and continuations)
+ * - Priority-based scheduling (separate queues per JobPriority)
  * - Wait/synchronization points
  *
  * Usage:
@@ -108,10 +125,42 @@ public:
     JobHandle createJobAsChild(JobHandle parent, JobFunction function, void* data = nullptr,
                                JobPriority priority = JobPriority::Normal);
 
+    /**
+     * @brief Create a job that runs once another job has completed
+     *
+     * Equivalent to createJob() followed by addContinuation().
+     *
+     * @param antecedent Handle to the job that must complete first
+     * @param function The function to execute
+     * @param data User data pointer
+     * @param priority Job priority
+     * @return Handle to the created job, or an invalid handle on failure
+     */
+    JobHandle createContinuation(JobHandle antecedent, JobFunction function, void* data = nullptr,
+                                 JobPriority priority = JobPriority::Normal);
+
+    /**
+     * @brief Make a job run only after another job has completed
+     *
+     * When the antecedent (and all its children) completes it schedules the
+     * continuation, no thread has to wait for it. A job may depend on several
+     * antecedents and is scheduled when the last one completes, but only after
+     * run() has been called on it too.
+     *
+     * Must be called before run() is called on either job. A job can have at
+     * most MAX_JOB_CONTINUATIONS continuations.
+     *
+     * @param antecedent Handle to the job that must complete first
+     * @param continuation Handle to the job to run afterwards
+     * @return true if successful, false if a handle is invalid or the antecedent is full
+     */
+    bool addContinuation(JobHandle antecedent, JobHandle continuation);
+
     /**
      * @brief Run a job
      *
-     * Adds the job to the queue for execution by worker threads.
+     * Adds the job to the queue for execution by worker threads. A job with
+     * unfinished antecedents is queued once the last of them completes.
      *
      * @param handle Handle to the job
      */
@@ -155,6 +204,16 @@ public:
      */
     uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
 
+    /**
+     * @brief Get the CPU cores the process is allowed to run on
+     *
+     * Honors the process affinity mask on Linux, elsewhere all hardware
+     * threads are reported.
+     *
+     * @return Indices of the cores in ascending order
+     */
+    static std::vector<int32_t> getAvailableCores();
+
     /**
      * @brief Get the current thread's worker ID
      *
@@ -162,40 +221,211 @@ public:
      */
     uint32_t getCurrentWorkerId() const;
 
+    /**
+     * @brief Run a function over a range of indices in parallel
+     *
+     * The range is split recursively into child jobs until the pieces are no
+     * larger than the effective grain size, see getGrainSize(). The calling
+     * thread takes part in the work and the call returns once the whole range
+     * has been processed.
+     *
+     * @code
+     * js.parallelFor(0, count, 64, [&](uint32_t first, uint32_t last) {
+     *     for (uint32_t i = first; i < last; ++i) {
+     *         positions[i] = transform * positions[i];
+     *     }
+     * });
+     * @endcode
+     *
+     * @param begin First index of the range
+     * @param end One past the last index of the range
+     * @param grainSize Minimum number of indices per job (0 = automatic)
+     * @param function Called as function(first, last) for each sub-range
+     * @param priority Priority of the spawned jobs
+     */
+    template <typename Function>
+    void parallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, Function&& function,
+                     JobPriority priority = JobPriority::Normal)
+    {
+        using Fn = std::remove_reference_t<Function>;
+        parallelForImpl(
+            begin, end, grainSize, priority,
+            [](void* context, uint32_t first, uint32_t last) {
+                (*static_cast<Fn*>(context))(first, last);
+            },
+            const_cast<void*>(static_cast<const void*>(std::addressof(function))));
+    }
+
+    /**
+     * @brief Reduce a range of indices in parallel
+     *
+     * The range is cut into chunks of the effective grain size, each chunk is
+     * mapped to a partial result in parallel, then the partial results are
+     * combined in chunk order on the calling thread. The result is therefore
+     * deterministic as long as reduce is associative.
+     *
+     * @code
+     * float total = js.parallelReduce(0, count, 0, 0.0f,
+     *     [&](uint32_t first, uint32_t last) {
+     *         float sum = 0.0f;
+     *         for (uint32_t i = first; i < last; ++i) sum += values[i];
+     *         return sum;
+     *     },
+     *     [](float a, float b) { return a + b; });
+     * @endcode
+     *
+     * @param begin First index of the range
+     * @param end One past the last index of the range
+     * @param grainSize Minimum number of indices per chunk (0 = automatic)
+     * @param identity Identity value of reduce, returned for an empty range
+     * @param map Called as map(first, last) and returns the partial result of a chunk
+     * @param reduce Called as reduce(a, b) to combine two results
+     * @param priority Priority of the spawned jobs
+     * @return The reduced value
+     */
+    template <typename T, typename MapFunction, typename ReduceFunction>
+    T parallelReduce(uint32_t begin, uint32_t end, uint32_t grainSize, T identity,
+                     MapFunction&& map, ReduceFunction&& reduce,
+                     JobPriority priority = JobPriority::Normal)
+    {
+        if (begin >= end) {
+            return identity;
+        }
+
+        const uint32_t grain = getGrainSize(end - begin, grainSize);
+        const uint32_t numChunks = (end - begin + grain - 1) / grain;
+        std::vector<T> partials(numChunks, identity);
+
+        parallelFor(
+            0, numChunks, 1,
+            [&](uint32_t first, uint32_t last) {
+                for (uint32_t chunk = first; chunk < last; ++chunk) {
+                    uint32_t chunkBegin = begin + chunk * grain;
+                    uint32_t chunkEnd = std::min(end, chunkBegin + grain);
+                    partials[chunk] = map(chunkBegin, chunkEnd);
+                }
+            },
+            priority);
+
+        T result = std::move(identity);
+        for (auto& partial : partials) {
+            result = reduce(std::move(result), std::move(partial));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Get the effective grain size used to split a range
+     *
+     * The requested grain size is raised so that a range is not cut into more
+     * than PARALLEL_SPLITS_PER_THREAD pieces per thread (workers + caller).
+     *
+     * @param count Number of indices in the range
+     * @param grainSize Requested grain size (0 = automatic)
+     * @return Number of indices per job, at least 1
+     */
+    uint32_t getGrainSize(uint32_t count, uint32_t grainSize) const;
+
+    /**
+     * @brief Get the profiling counters of a worker
+     *
+     * The counters are only collected when JobSystemConfig::enableProfiling is set.
+     *
+     * @param workerId ID of the worker
+     * @return Counters of the worker, all zero for an invalid ID
+     */
+    WorkerStats getWorkerStats(uint32_t workerId) const;
+
+    /**
+     * @brief Clear the profiling counters and timelines of all workers
+     *
+     * Also restarts the timeline origin. Should only be called while no jobs are running.
+     */
+    void resetStats();
+
+    /**
+     * @brief Log the profiling counters of all workers
+     */
+    void logStats() const;
+
+    /**
+     * @brief Write the recorded job timelines in the Chrome trace event format
+     *
+     * The output can be loaded in chrome://tracing or Perfetto, each worker
+     * shows up as a thread. Timelines are only recorded when
+     * JobSystemConfig::enableTimeline is set, and should only be written while
+     * no jobs are running.
+     *
+     * @param out Stream receiving the JSON document
+     */
+    void writeChromeTrace(std::ostream& out) const;
+
+    /**
+     * @brief Upper bound on the number of pieces per thread a parallel range is split into
+     */
+    static constexpr uint32_t PARALLEL_SPLITS_PER_THREAD = 8;
+
     // Internal methods used by Worker class
     Job* getJob(uint32_t index);
     void finishJob(Job* job);
-    std::optional<uint32_t> stealFromOthers(uint32_t currentWorkerId);
-    std::optional<uint32_t> popFromGlobalQueue();
+    std::optional<uint32_t> stealFromOthers(uint32_t currentWorkerId, JobPriority priority);
+    std::optional<uint32_t> popFromGlobalQueue(JobPriority priority);
+    void wakeWorkers(uint32_t count);
     void wakeAllWorkers();
 
 private:
     friend class Worker;
 
     JobSystem() = default;
-    ~JobSystem() = default;
+    ~JobSystem();
     JobSystem(const JobSystem&) = delete;
     JobSystem& operator=(const JobSystem&) = delete;
 
     uint32_t allocateJob();
     void freeJob(uint32_t index);
+    Job* resolveJob(JobHandle handle);
+    void schedule(uint32_t index);
     void helpWithJob();
 
+    using RangeFunction = void (*)(void* context, uint32_t first, uint32_t last);
+    struct ParallelForContext;
+    void parallelForImpl(uint32_t begin, uint32_t end, uint32_t grainSize, JobPriority priority,
+                         RangeFunction function, void* context);
+    void splitRange(ParallelForContext& context, uint32_t begin, uint32_t end);
+    int64_t getTimelineTime() const;
+
     std::atomic<bool> m_initialized{false};
     std::atomic<bool> m_shuttingDown{false};
 
+    // Jobs to run after a job, kept out of Job so that it fits in a cache line
+    struct Continuations {
+        uint32_t jobs[MAX_JOB_CONTINUATIONS] = {};  // Pool indices
+        uint8_t count = 0;
+    };
+
     // Job pool
     std::vector<std::unique_ptr<Job>> m_jobs;
-    std::unique_ptr<std::atomic<bool>[]> m_jobAllocated;
+    std::vector<Continuations> m_continuations;  // Indexed like m_jobs
+    JobFreeList m_freeJobs;
     size_t m_maxJobs{0};
-    std::atomic<uint32_t> m_nextJobIndex{0};
     std::atomic<uint32_t> m_generation{1};
 
     // Workers
     std::vector<std::unique_ptr<Worker>> m_workers;
 
-    // Global queue for distributing work
-    WorkStealingQueue<uint32_t, 8192> m_globalQueue;
+    // Global queues for jobs submitted from non-worker threads, one per priority level.
+    // Any thread may push, so these are multi-producer unlike the worker queues.
+    std::array<MpmcQueue<uint32_t>, JOB_PRIORITY_COUNT> m_globalQueues;
+
+    // Idle workers park here until jobs are submitted
+    EventCount m_workAvailable;
+    uint32_t m_spinCount{0};
+
+    // Profiling
+    bool m_profilingEnabled{false};
+    bool m_timelineEnabled{false};
+    size_t m_timelineCapacity{0};
+    std::chrono::steady_clock::time_point m_timelineOrigin;
 
     // Synchronization for pending jobs count
     std::atomic<uint32_t> m_pendingJobs{0};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <assert.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace ocf {
+namespace job {
+
+/**
+ * @brief Bounded lock-free multi-producer, multi-consumer queue
+ *
+ * Used to inject jobs from threads that don't own a work stealing queue.
+ * Each cell carries a sequence number telling producers and consumers
+ * whether it is free for the current lap, so push() and pop() only contend
+ * on their own position counter (Dmitry Vyukov's bounded MPMC queue).
+ *
+ * @tparam T Type of elements stored in the queue
+ */
+template <typename T>
+class MpmcQueue {
+public:
+    MpmcQueue() = default;
+
+    explicit MpmcQueue(size_t capacity) { reset(capacity); }
+
+    ~MpmcQueue() = default;
+
+    // Non-copyable
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /**
+     * @brief Reallocate the queue with a new capacity, dropping all elements
+     *
+     * Not thread-safe, must only be called while no other thread uses the queue.
+     *
+     * @param capacity Maximum number of elements (must be a power of 2)
+     */
+    void reset(size_t capacity)
+    {
+        assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+        m_cells = std::make_unique<Cell[]>(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_mask = capacity - 1;
+        m_enqueuePos.store(0, std::memory_order_relaxed);
+        m_dequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Push an element (any thread)
+     *
+     * @param item The item to push
+     * @return true if successful, false if queue is full
+     */
+    bool push(const T& item)
+    {
+        Cell* cell;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                return false;  // Queue is full
+            }
+            else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop the oldest element (any thread)
+     *
+     * @return The popped item, or std::nullopt if queue is empty
+     */
+    std::optional<T> pop()
+    {
+        Cell* cell;
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                return std::nullopt;  // Queue is empty
+            }
+            else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        T item = cell->data;
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return item;
+    }
+
+    /**
+     * @brief Get the current size of the queue
+     *
+     * @return Approximate number of elements in the queue
+     */
+    size_t size() const
+    {
+        size_t enqueuePos = m_enqueuePos.load(std::memory_order_relaxed);
+        size_t dequeuePos = m_dequeuePos.load(std::memory_order_relaxed);
+        return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+    }
+
+    /**
+     * @brief Check if the queue is empty
+     *
+     * @return true if queue appears to be empty
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Get the maximum number of elements
+     *
+     * @return Capacity of the queue
+     */
+    size_t capacity() const { return m_cells ? m_mask + 1 : 0; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T data{};
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask{0};
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_dequeuePos{0};
+};
+
+}  // namespace job
+}  // namespace ocf
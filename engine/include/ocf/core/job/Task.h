@@ -0,0 +1,434 @@
+#pragma once
+
+#include "ocf/core/job/JobSystem.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define OCF_JOB_COROUTINES 1
+#else
+#define OCF_JOB_COROUTINES 0
+#endif
+
+#if OCF_JOB_COROUTINES
+
+#include <assert.h>
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ocf {
+namespace job {
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+/**
+ * @brief Resumes the awaiting coroutine when a task completes
+ */
+struct TaskFinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+    {
+        // Symmetric transfer, resuming the continuation doesn't grow the stack
+        std::coroutine_handle<> continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+class TaskPromiseBase {
+public:
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    TaskFinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { m_exception = std::current_exception(); }
+
+    std::coroutine_handle<> continuation;
+
+protected:
+    void rethrowIfFailed() const
+    {
+        if (m_exception) {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+private:
+    std::exception_ptr m_exception;
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U&& value)
+    {
+        m_value.emplace(std::forward<U>(value));
+    }
+
+    T getResult()
+    {
+        rethrowIfFailed();
+        return std::move(*m_value);
+    }
+
+private:
+    std::optional<T> m_value;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object() noexcept;
+    void return_void() const noexcept {}
+    void getResult() { rethrowIfFailed(); }
+};
+
+/**
+ * @brief Eagerly started coroutine that destroys itself on completion
+ */
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+}  // namespace detail
+
+/**
+ * @brief Lazily started coroutine that produces a value of type T
+ *
+ * A Task does not run until it is awaited with co_await, or passed to
+ * syncWait() or whenAll(). The awaiting coroutine is suspended and resumed
+ * by the thread that completes the task, so no thread blocks while waiting.
+ * Work is moved onto JobSystem workers with resumeOnJobSystem().
+ *
+ * Usage:
+ * @code
+ * Task<std::vector<char>> loadFile(std::string path)
+ * {
+ *     co_await resumeOnJobSystem();  // Continue on a worker
+ *     co_return readAllBytes(path);
+ * }
+ *
+ * Task<> loadTexture(std::string path)
+ * {
+ *     std::vector<char> bytes = co_await loadFile(path);
+ *     decode(bytes);
+ * }
+ *
+ * syncWait(loadTexture("image.png"));
+ * @endcode
+ *
+ * Exceptions thrown by the coroutine are rethrown to the awaiter. A task can
+ * be awaited only once.
+ *
+ * @tparam T Type of the result
+ */
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    Task() = default;
+
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    {
+    }
+
+    Task(Task&& other) noexcept
+        : m_handle(std::exchange(other.m_handle, nullptr))
+    {
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task() { destroy(); }
+
+    // Non-copyable
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    /**
+     * @brief Check if the task holds a coroutine
+     *
+     * @return true if valid
+     */
+    bool isValid() const { return static_cast<bool>(m_handle); }
+
+    /**
+     * @brief Check if the coroutine has run to completion
+     *
+     * @return true if completed
+     */
+    bool isReady() const { return !m_handle || m_handle.done(); }
+
+    /**
+     * @brief Get the result of a completed task
+     *
+     * Rethrows the exception that ended the coroutine, if any.
+     *
+     * @return The value passed to co_return
+     */
+    T getResult()
+    {
+        assert(m_handle && m_handle.done());
+        return m_handle.promise().getResult();
+    }
+
+    /**
+     * @brief Start the task and suspend the caller until it completes
+     *
+     * @return Awaiter producing the result of the task
+     */
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter : ReadyAwaiter {
+            T await_resume() { return this->m_handle.promise().getResult(); }
+        };
+        return Awaiter{{m_handle}};
+    }
+
+    /**
+     * @brief Start the task and suspend the caller until it completes
+     *
+     * Unlike co_await on the task itself the result is not consumed, it can
+     * be read with getResult() afterwards.
+     *
+     * @return Awaiter producing no value
+     */
+    auto whenReady() noexcept { return ReadyAwaiter{m_handle}; }
+
+private:
+    struct ReadyAwaiter {
+        bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept
+        {
+            m_handle.promise().continuation = awaiter;
+            return m_handle;
+        }
+
+        void await_resume() const noexcept {}
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    void destroy()
+    {
+        if (m_handle) {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept
+{
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept
+{
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+/**
+ * @brief Awaiter that resumes the coroutine from a job
+ */
+class JobSystemAwaiter {
+public:
+    JobSystemAwaiter(JobSystem& jobSystem, JobPriority priority)
+        : m_jobSystem(jobSystem)
+        , m_priority(priority)
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        JobHandle job = m_jobSystem.createJob([handle](void*) { handle.resume(); }, nullptr,
+                                              m_priority);
+        if (!job.isValid()) {
+            // Pool exhausted or not initialized, keep running on this thread
+            return false;
+        }
+        m_jobSystem.run(job);
+        return true;
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    JobSystem& m_jobSystem;
+    JobPriority m_priority;
+};
+
+template <typename T>
+DetachedTask startAndSignal(Task<T>& task, JobSystem& jobSystem, JobHandle done,
+                            std::atomic<bool>& finished)
+{
+    co_await task.whenReady();
+
+    // Nothing of the caller may be touched after signaling
+    if (done.isValid()) {
+        jobSystem.run(done);
+    }
+    else {
+        finished.store(true, std::memory_order_release);
+    }
+}
+
+template <typename T>
+DetachedTask startAndCount(Task<T>& task, std::atomic<size_t>& remaining,
+                           std::coroutine_handle<> awaiter)
+{
+    co_await task.whenReady();
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        awaiter.resume();
+    }
+}
+
+template <typename T>
+class WhenAllAwaiter {
+public:
+    explicit WhenAllAwaiter(std::vector<Task<T>>& tasks)
+        : m_tasks(tasks)
+        , m_remaining(tasks.size() + 1)
+    {
+    }
+
+    bool await_ready() const noexcept { return m_tasks.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> awaiter)
+    {
+        for (Task<T>& task : m_tasks) {
+            startAndCount(task, m_remaining, awaiter);
+        }
+        // The extra count keeps the awaiter from being resumed before every task has started
+        return m_remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    std::vector<Task<T>>& m_tasks;
+    std::atomic<size_t> m_remaining;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Continue the awaiting coroutine on a JobSystem worker
+ *
+ * The coroutine is suspended and resumed from a newly scheduled job. If no
+ * job can be created it simply continues on the current thread.
+ *
+ * @param jobSystem Job system to resume on
+ * @param priority Priority of the resuming job
+ * @return Awaiter to co_await
+ */
+inline detail::JobSystemAwaiter resumeOnJobSystem(JobSystem& jobSystem = JobSystem::getInstance(),
+                                                  JobPriority priority = JobPriority::Normal)
+{
+    return detail::JobSystemAwaiter(jobSystem, priority);
+}
+
+/**
+ * @brief Run several tasks concurrently and wait for all of them
+ *
+ * Every task is started before the caller is suspended, so tasks that move
+ * to the job system overlap. The results are returned in the order of the
+ * tasks, the first exception thrown by a task is rethrown.
+ *
+ * @param tasks Tasks to run
+ * @return Task producing the results
+ */
+template <typename T>
+Task<std::vector<T>> whenAll(std::vector<Task<T>> tasks)
+{
+    co_await detail::WhenAllAwaiter<T>(tasks);
+
+    std::vector<T> results;
+    results.reserve(tasks.size());
+    for (Task<T>& task : tasks) {
+        results.push_back(task.getResult());
+    }
+    co_return results;
+}
+
+/**
+ * @brief Run several tasks concurrently and wait for all of them
+ *
+ * @param tasks Tasks to run
+ * @return Task completing once every task has completed
+ */
+inline Task<void> whenAll(std::vector<Task<void>> tasks)
+{
+    co_await detail::WhenAllAwaiter<void>(tasks);
+
+    for (Task<void>& task : tasks) {
+        task.getResult();
+    }
+}
+
+/**
+ * @brief Block the calling thread until a task has completed
+ *
+ * Meant for code outside of coroutines, e.g. the main thread. While waiting
+ * the thread helps executing jobs like JobSystem::wait().
+ *
+ * @param task Task to run
+ * @param jobSystem Job system the task runs on
+ * @return The result of the task
+ */
+template <typename T>
+T syncWait(Task<T> task, JobSystem& jobSystem = JobSystem::getInstance())
+{
+    // The job is run once the task has completed, waiting on it helps with other jobs
+    JobHandle done = jobSystem.createJob([](void*) {});
+    std::atomic<bool> finished{false};
+
+    detail::startAndSignal(task, jobSystem, done, finished);
+
+    if (done.isValid()) {
+        jobSystem.wait(done);
+    }
+    else {
+        while (!finished.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+    return task.getResult();
+}
+
+}  // namespace job
+}  // namespace ocf
+
+#endif  // OCF_JOB_COROUTINES
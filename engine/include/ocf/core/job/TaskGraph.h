@@ -0,0 +1,115 @@
+#pragma once
+
+#include "ocf/core/job/Job.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ocf {
+namespace job {
+
+class JobSystem;
+
+/**
+ * @brief Reusable graph of jobs with dependencies
+ *
+ * A TaskGraph describes a set of tasks and the order constraints between
+ * them once, and can then be submitted any number of times (e.g. once per
+ * frame). Each submission turns every task into a job and wires the
+ * dependencies as job continuations, so no thread blocks between stages.
+ *
+ * Usage:
+ * @code
+ * TaskGraph frame;
+ * auto update = frame.addTask([](void*) { updateScene(); });
+ * auto cull = frame.addTask([](void*) { cullScene(); });
+ * auto build = frame.addTask([](void*) { buildCommands(); });
+ * frame.addDependency(update, cull);
+ * frame.addDependency(cull, build);
+ *
+ * // Every frame
+ * JobHandle done = frame.submit(JobSystem::getInstance());
+ * ...
+ * JobSystem::getInstance().wait(done);
+ * @endcode
+ *
+ * The graph must be acyclic, and it must not be modified, submitted again or
+ * destroyed until the handle returned by submit() has completed.
+ */
+class TaskGraph {
+public:
+    using TaskId = uint32_t;
+
+    TaskGraph() = default;
+    ~TaskGraph() = default;
+
+    // Non-copyable
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    /**
+     * @brief Add a task to the graph
+     *
+     * @param function The function to execute on every submission
+     * @param data User data pointer passed to the function
+     * @param priority Priority of the task's job
+     * @return Identifier of the task
+     */
+    TaskId addTask(JobFunction function, void* data = nullptr,
+                   JobPriority priority = JobPriority::Normal);
+
+    /**
+     * @brief Make a task run only after another one has completed
+     *
+     * @param before Task that must complete first
+     * @param after Task that runs afterwards
+     */
+    void addDependency(TaskId before, TaskId after);
+
+    /**
+     * @brief Submit all tasks of the graph for execution
+     *
+     * If the job pool cannot hold the whole graph, the tasks are executed on
+     * the calling thread in dependency order instead.
+     *
+     * @param jobSystem Job system to run the tasks on
+     * @return Handle that completes once every task of this submission has completed
+     */
+    JobHandle submit(JobSystem& jobSystem);
+
+    /**
+     * @brief Remove all tasks and dependencies
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of tasks in the graph
+     *
+     * @return Number of tasks
+     */
+    size_t getTaskCount() const { return m_tasks.size(); }
+
+private:
+    struct Task {
+        JobFunction function;
+        void* data = nullptr;
+        JobPriority priority = JobPriority::Normal;
+        std::vector<TaskId> successors;
+    };
+
+    void runTask(TaskId id, void* data);
+    bool connect(JobSystem& jobSystem, JobHandle root, JobHandle antecedent,
+                 const TaskId* successors, size_t count, JobPriority priority);
+    void runInline();
+
+    std::vector<Task> m_tasks;
+
+    // Per-submission state, reused to avoid reallocating every frame
+    std::vector<JobHandle> m_handles;
+    std::vector<JobHandle> m_relays;
+    bool m_runInline = false;
+};
+
+}  // namespace job
+}  // namespace ocf
@@ -3,7 +3,10 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <type_traits>
+#include <vector>
 
 namespace ocf {
 namespace job {
@@ -15,22 +18,27 @@ namespace job {
  * - push() and pop() from the owner thread (LIFO)
  * - steal() from other threads (FIFO)
  *
- * The implementation uses atomic operations for thread safety without locks.
+ * The implementation is a Chase-Lev deque over a growable circular array.
+ * When push() finds the array full, the owner copies the elements to an
+ * array twice as large. Thieves may still be reading the old array, so it is
+ * retired rather than freed and only released with the queue.
  *
- * @tparam T Type of elements stored in the queue
- * @tparam Capacity Maximum number of elements the queue can hold (must be power of 2)
+ * @tparam T Type of elements stored in the queue (must be trivially copyable)
+ * @tparam InitialCapacity Number of elements before the first growth (must be power of 2)
  */
-template <typename T, size_t Capacity = 4096>
+template <typename T, size_t InitialCapacity = 1024>
 class WorkStealingQueue {
-    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+    static_assert((InitialCapacity & (InitialCapacity - 1)) == 0,
+                  "InitialCapacity must be a power of 2");
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
 
 public:
     WorkStealingQueue()
         : m_top(0)
         , m_bottom(0)
     {
-        // Buffer elements are default-initialized; no need to explicitly initialize
-        // since they will be overwritten when pushed
+        m_retired.push_back(std::make_unique<Array>(InitialCapacity));
+        m_array.store(m_retired.back().get(), std::memory_order_relaxed);
     }
 
     ~WorkStealingQueue() = default;
@@ -42,19 +50,22 @@ public:
     /**
      * @brief Push an element to the bottom of the queue (owner thread only)
      *
+     * Grows the queue if it is full.
+     *
      * @param item The item to push
-     * @return true if successful, false if queue is full
+     * @return true, the push always succeeds
      */
     bool push(const T& item)
     {
         int64_t bottom = m_bottom.load(std::memory_order_relaxed);
         int64_t top = m_top.load(std::memory_order_acquire);
+        Array* array = m_array.load(std::memory_order_relaxed);
 
-        if (bottom - top >= static_cast<int64_t>(Capacity)) {
-            return false;  // Queue is full
+        if (bottom - top >= static_cast<int64_t>(array->capacity())) {
+            array = grow(array, top, bottom);
         }
 
-        m_buffer[bottom & MASK] = item;
+        array->put(bottom, item);
         std::atomic_thread_fence(std::memory_order_release);
         m_bottom.store(bottom + 1, std::memory_order_relaxed);
         return true;
@@ -68,13 +79,14 @@ public:
     std::optional<T> pop()
     {
         int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        Array* array = m_array.load(std::memory_order_relaxed);
         m_bottom.store(bottom, std::memory_order_relaxed);
         std::atomic_thread_fence(std::memory_order_seq_cst);
 
         int64_t top = m_top.load(std::memory_order_relaxed);
 
         if (top <= bottom) {
-            T item = m_buffer[bottom & MASK];
+            T item = array->get(bottom);
 
             if (top == bottom) {
                 // Last element, need to race with stealers
@@ -106,7 +118,8 @@ public:
         int64_t bottom = m_bottom.load(std::memory_order_acquire);
 
         if (top < bottom) {
-            T item = m_buffer[top & MASK];
+            Array* array = m_array.load(std::memory_order_acquire);
+            T item = array->get(top);
 
             if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
                                                std::memory_order_relaxed)) {
@@ -138,12 +151,57 @@ public:
      */
     bool empty() const { return size() == 0; }
 
+    /**
+     * @brief Get the current capacity of the queue
+     *
+     * @return Number of elements the queue can hold before growing again
+     */
+    size_t capacity() const { return m_array.load(std::memory_order_relaxed)->capacity(); }
+
 private:
-    static constexpr size_t MASK = Capacity - 1;
+    class Array {
+    public:
+        explicit Array(size_t capacity)
+            : m_mask(capacity - 1)
+            , m_data(std::make_unique<std::atomic<T>[]>(capacity))
+        {
+        }
+
+        size_t capacity() const { return m_mask + 1; }
+
+        T get(int64_t index) const
+        {
+            return m_data[static_cast<size_t>(index) & m_mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, const T& item)
+        {
+            m_data[static_cast<size_t>(index) & m_mask].store(item, std::memory_order_relaxed);
+        }
+
+    private:
+        size_t m_mask;
+        std::unique_ptr<std::atomic<T>[]> m_data;
+    };
+
+    Array* grow(Array* array, int64_t top, int64_t bottom)
+    {
+        auto larger = std::make_unique<Array>(array->capacity() * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            larger->put(i, array->get(i));
+        }
+
+        // The old array stays alive in m_retired, a thief may still read from it
+        Array* result = larger.get();
+        m_retired.push_back(std::move(larger));
+        m_array.store(result, std::memory_order_release);
+        return result;
+    }
 
     alignas(64) std::atomic<int64_t> m_top;
     alignas(64) std::atomic<int64_t> m_bottom;
-    alignas(64) T m_buffer[Capacity];
+    alignas(64) std::atomic<Array*> m_array{nullptr};
+    std::vector<std::unique_ptr<Array>> m_retired;  // Owner thread only
 };
 
 }  // namespace job
@@ -2,26 +2,69 @@
 
 #include "ocf/core/job/Job.h"
 #include "ocf/core/job/WorkStealingQueue.h"
+#include "ocf/platform/PlatformConfig.h"
 
+#include <array>
 #include <atomic>
-#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
-#include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
+#if (OCF_TARGET_PLATFORM == OCF_PLATFORM_LINUX)
+#include <pthread.h>
+#endif
+
 namespace ocf {
 namespace job {
 
 class JobSystem;
 
+/**
+ * @brief Profiling counters of a worker
+ *
+ * Only collected while JobSystemConfig::enableProfiling is set.
+ */
+struct WorkerStats {
+    uint64_t jobsExecuted = 0;     ///< Jobs run by the worker
+    uint64_t stealsAttempted = 0;  ///< Victim queues probed while stealing
+    uint64_t stealsSucceeded = 0;  ///< Jobs obtained by stealing
+    uint64_t idleTimeNs = 0;       ///< Time spent without a job, spinning or parked
+    size_t queueDepth = 0;         ///< Jobs currently in the local queues
+    size_t maxQueueDepth = 0;      ///< Largest local queue depth seen on push
+};
+
+/**
+ * @brief Settings applied to a worker thread when it starts
+ */
+struct WorkerThreadConfig {
+    std::string name;    ///< Thread name shown in debuggers and profilers (empty = unnamed)
+    int32_t core = -1;   ///< CPU core the thread is pinned to (-1 = not pinned)
+    size_t stackSize = 0;  ///< Stack size in bytes (0 = platform default)
+};
+
+/**
+ * @brief Execution span of a job, recorded while JobSystemConfig::enableTimeline is set
+ */
+struct TimelineEvent {
+    uint32_t jobId = 0;                          ///< Id of the job's handle
+    JobPriority priority = JobPriority::Normal;  ///< Priority of the job
+    int64_t beginNs = 0;  ///< Start time, relative to the job system's timeline origin
+    int64_t endNs = 0;    ///< End time, relative to the job system's timeline origin
+};
+
 /**
  * @brief Worker thread that executes jobs
  *
- * Each worker has its own local queue and can steal jobs from other workers
- * when its local queue is empty.
+ * Each worker has one local queue per priority level and can steal jobs from
+ * other workers when its local queues are empty. Higher priority jobs are
+ * always picked first, except that a pending Low priority job is picked after
+ * LOW_PRIORITY_STARVATION_LIMIT jobs of higher priority so it cannot starve.
+ *
+ * An idle worker keeps looking for work for a configurable number of spins,
+ * then parks on the job system's event count until new jobs are submitted.
  */
 class Worker {
 public:
@@ -44,44 +87,67 @@ public:
 
     /**
      * @brief Start the worker thread
+     *
+     * @param config Name, affinity and stack size of the thread
      */
-    void start();
+    void start(const WorkerThreadConfig& config = {});
 
     /**
      * @brief Stop the worker thread
      */
     void stop();
 
+    /**
+     * @brief Number of higher priority jobs after which a pending Low priority job runs
+     */
+    static constexpr uint32_t LOW_PRIORITY_STARVATION_LIMIT = 16;
+
     /**
      * @brief Push a job index to this worker's local queue
      *
      * @param jobIndex Index of the job in the job pool
-     * @return true if successful, false if queue is full
+     * @param priority Priority of the job, selects the local queue
+     * @return true if successful (the local queues grow as needed)
      */
-    bool pushJob(uint32_t jobIndex);
+    bool pushJob(uint32_t jobIndex, JobPriority priority);
 
     /**
-     * @brief Try to steal a job from this worker
+     * @brief Try to steal a job of the given priority from this worker
      *
+     * @param priority Priority of the queue to steal from
      * @return Job index if successful, empty optional otherwise
      */
-    std::optional<uint32_t> steal();
+    std::optional<uint32_t> steal(JobPriority priority);
 
     /**
-     * @brief Wake up this worker if it's sleeping
+     * @brief Get the worker ID
      *
-     * This method is thread-safe and can be called from any thread.
-     * It uses a condition variable to signal the worker thread to wake up
-     * and check for new work.
+     * @return Worker ID
      */
-    void wakeUp();
+    uint32_t getId() const { return m_workerId; }
 
     /**
-     * @brief Get the worker ID
+     * @brief Get a snapshot of the profiling counters
      *
-     * @return Worker ID
+     * @return Counters accumulated since start or the last resetStats()
      */
-    uint32_t getId() const { return m_workerId; }
+    WorkerStats getStats() const;
+
+    /**
+     * @brief Clear the profiling counters and the timeline
+     *
+     * Should only be called while the job system is idle.
+     */
+    void resetStats();
+
+    /**
+     * @brief Get the recorded job timeline
+     *
+     * Should only be read while the job system is idle.
+     *
+     * @return Events in execution order
+     */
+    const std::vector<TimelineEvent>& getTimeline() const { return m_timeline; }
 
     /**
      * @brief Check if the worker is running
@@ -91,19 +157,40 @@ public:
     bool isRunning() const { return m_running.load(std::memory_order_relaxed); }
 
 private:
+    friend class JobSystem;
+
     void threadFunc();
+    void execute(uint32_t jobIndex);
+    void recordStealAttempt(bool succeeded);
+    static void increment(std::atomic<uint64_t>& counter, uint64_t value = 1);
     std::optional<uint32_t> getJob();
+    std::optional<uint32_t> getJob(JobPriority priority);
+
+    void applyThreadConfig();
 
     JobSystem& m_jobSystem;
     uint32_t m_workerId;
+    WorkerThreadConfig m_threadConfig;
+#if (OCF_TARGET_PLATFORM == OCF_PLATFORM_LINUX)
+    // std::thread can't set the stack size
+    pthread_t m_thread{};
+    bool m_joinable{false};
+#else
     std::thread m_thread;
+#endif
     std::atomic<bool> m_running{false};
     std::atomic<bool> m_shouldStop{false};
 
-    WorkStealingQueue<uint32_t, 4096> m_localQueue;
+    std::array<WorkStealingQueue<uint32_t, 256>, JOB_PRIORITY_COUNT> m_localQueues;
+    uint32_t m_jobsSinceLowPriority{0};
 
-    std::mutex m_sleepMutex;
-    std::condition_variable m_sleepCondition;
+    // Profiling, only written by the worker thread
+    std::atomic<uint64_t> m_jobsExecuted{0};
+    std::atomic<uint64_t> m_stealsAttempted{0};
+    std::atomic<uint64_t> m_stealsSucceeded{0};
+    std::atomic<uint64_t> m_idleTimeNs{0};
+    std::atomic<uint64_t> m_maxQueueDepth{0};
+    std::vector<TimelineEvent> m_timeline;
 };
 
 }  // namespace job
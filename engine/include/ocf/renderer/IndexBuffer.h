@@ -16,12 +16,13 @@ public:
         UINT = uint8_t(backend::ElementType::UNSIGNED_INT)
     };
 
-    static IndexBuffer* create(IndexType indexType, uint32_t indexCount);
+    static IndexBuffer* create(IndexType indexType, uint32_t indexCount,
+                               BufferUsage usage = BufferUsage::STATIC);
 
     IndexBuffer();
     ~IndexBuffer();
 
-    bool init(IndexType indexType, uint32_t indexCount);
+    bool init(IndexType indexType, uint32_t indexCount, BufferUsage usage);
 
     void createBuffer();
 
@@ -29,6 +30,14 @@ public:
 
     void setBufferData(const void* data, size_t size, size_t offset);
 
+    /**
+     * @brief Append data to a buffer created with BufferUsage::STREAM
+     *
+     * @return Byte offset of the data in the buffer, SIZE_MAX if the buffer is
+     *         full for this frame
+     */
+    size_t streamData(const void* data, size_t size);
+
     uint32_t getIndexCount() const { return m_indexCount; }
     IndexType getElementType() const { return m_indexType; }
 
@@ -36,6 +45,7 @@ private:
     IndexBufferHandle m_handle;
     uint32_t m_indexCount;
     IndexType m_indexType;
+    BufferUsage m_usage;
 };
 
 } // namespace ocf
\ No newline at end of file
@@ -52,6 +52,7 @@ public:
     void setDepth(float depth) { m_depth = depth; }
 
     PipelineState& getPipelineState() { return m_pipelineState; }
+    const PipelineState& getPipelineState() const { return m_pipelineState; }
 
     RenderPrimitiveHandle getHandle() const { return m_handle; }
 
@@ -17,6 +17,7 @@ class Driver;
 
 class Renderer {
 public:
+    // Initial capacity of the triangle buffers, they grow to fit the batches of a frame
     static constexpr int VBO_SIZE = 0x10000;
     static constexpr int INDEX_VBO_SIZE = VBO_SIZE * 6 / 4;
 
@@ -43,14 +44,48 @@ public:
 
     uint32_t getDrawVertexCount() const { return m_drawVertexCount; }
 
+    /**
+     * @brief Keep unchanged triangle batches in the staging arrays across frames
+     *
+     * When a batch consists of the same commands as the last filled one and
+     * none of them changed (see TrianglesCommand::setTransformUnchanged()),
+     * its vertices and indices are not rebuilt. The batch is uploaded once to
+     * buffers of its own and drawn from them until it changes, instead of
+     * being streamed every frame. Pays off for mostly static scenes drawn in a
+     * single batch, e.g. UI and backgrounds.
+     *
+     * @param enabled true to enable, disabled by default
+     */
+    void setStaticBatching(bool enabled);
+    bool isStaticBatching() const { return m_staticBatching; }
+
 protected:
     void flush();
     void flush2D();
     void flush3D();
     void visitRenderQueue(RenderQueue& queue);
-    void doVisitRenderQueue(const std::vector<RenderCommand*>& renderCommands);
+    void doVisitRenderQueue(const RenderQueue& queue, size_t begin, size_t end);
     void processRenderCommand(RenderCommand* command);
-    void trianglesVerticesAndIndices(TrianglesCommand* command, unsigned int vertexBufferOffset);
+    struct TrianglesOffsets {
+        unsigned int vertex = 0;
+        unsigned int index = 0;
+    };
+    void trianglesVerticesAndIndices(TrianglesCommand* command, const TrianglesOffsets& offsets,
+                                     unsigned int vertexBufferOffset);
+    void fillTrianglesVerticesAndIndices(unsigned int vertexBufferOffset);
+    struct TriangleBuffers {
+        VertexBuffer* vertexBuffer = nullptr;
+        IndexBuffer* indexBuffer = nullptr;
+        backend::RenderPrimitiveHandle renderPrimitive;
+        unsigned int vertexCapacity = 0;
+        unsigned int indexCapacity = 0;
+    };
+    void reserveTriangleBuffers(unsigned int vertexCount, unsigned int indexCount);
+    void createTriangleBuffers(TriangleBuffers& buffers, unsigned int vertexCapacity,
+                              unsigned int indexCapacity, backend::BufferUsage usage);
+    void destroyTriangleBuffers(TriangleBuffers& buffers);
+    bool isStagedTrianglesBatch() const;
+    void uploadStaticTrianglesBatch();
     void drawTrianglesCommand();
     void drawMeshCommand(RenderCommand* command);
 
@@ -58,6 +93,10 @@ private:
     std::vector<RenderQueue> m_renderGroups;
     backend::Driver* m_driver;
     std::vector<TrianglesCommand*> m_trianglesCommands;
+    std::vector<TrianglesOffsets> m_trianglesOffsets;   // Where each command goes in the arrays
+    std::vector<TrianglesCommand*> m_stagedTrianglesCommands; // Batch in the staging arrays
+    bool m_staticBatching = false;
+    bool m_staticBatchUploaded = false; // The staged batch is in m_staticTriangleBuffers
 
     uint32_t m_drawCallCount = 0;
     uint32_t m_drawVertexCount = 0;
@@ -69,12 +108,12 @@ private:
     };
     TriangleBatchToDraw* m_triangleBatchToDraw = nullptr;
     int m_triangleBatchToDrawSize = 256;
-    backend::RenderPrimitiveHandle m_triangleRenderPrimitive;
-    VertexBuffer* m_triangleVertexBuffer = nullptr;
-    IndexBuffer* m_triangleIndexBuffer = nullptr;
+    TriangleBuffers m_triangleBuffers;          // Stream buffers, capacity per frame
+    TriangleBuffers m_staticTriangleBuffers;    // Retained buffers of the static batch
 
-    Vertex3fC3fT2f m_triangleVertices[VBO_SIZE];
-    unsigned short m_triangleIndices[INDEX_VBO_SIZE];
+    // Batch staging, 32-bit indices so a batch isn't limited to 65536 vertices
+    std::vector<Vertex3fC3fT2f> m_triangleVertices;
+    std::vector<uint32_t> m_triangleIndices;
     unsigned int m_triangleVertexCount = 0;
     unsigned int m_triangleIndexCount = 0;
 };
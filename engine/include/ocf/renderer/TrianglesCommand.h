@@ -1,6 +1,7 @@
 #pragma once
 #include "ocf/base/Types.h"
 #include "ocf/renderer/RenderCommand.h"
+#include <vector>
 
 namespace ocf {
 
@@ -41,11 +42,49 @@ public:
     Texture* getTexture() const { return m_texture; }
     BlendFunc getBlendFunc() const { return m_blendFunc; }
 
+    /**
+     * @brief Keep a copy of the world space vertices computed by the renderer
+     *
+     * Meant for commands whose vertices rarely change, see setTransformUnchanged().
+     */
+    void setCachingWorldVertices(bool caching);
+    bool isCachingWorldVertices() const { return m_cachingWorldVertices; }
+
+    /**
+     * @brief Tell the renderer that neither the vertices nor the model view changed
+     *
+     * Must be called after init(), which resets the flag. When set, the
+     * renderer reuses the world space vertices cached on the last frame
+     * instead of transforming the vertices again.
+     */
+    void setTransformUnchanged(bool unchanged) { m_transformUnchanged = unchanged; }
+    bool isTransformUnchanged() const { return m_transformUnchanged; }
+
+    /**
+     * @brief Get the cached world space vertices, if they are still valid
+     *
+     * @return The vertices, or nullptr if they have to be transformed
+     */
+    const Vertex3fC3fT2f* getCachedWorldVertices() const
+    {
+        return (m_transformUnchanged && m_worldVerticesValid) ? m_worldVertices.data() : nullptr;
+    }
+
+    /**
+     * @brief Store the world space vertices computed by the renderer
+     */
+    void cacheWorldVertices(const Vertex3fC3fT2f* vertices);
+
 protected:
     void generateMaterialID();
 
     uint32_t m_materialID;
 
+    bool m_cachingWorldVertices = false;
+    bool m_transformUnchanged = false;
+    bool m_worldVerticesValid = false;
+    std::vector<Vertex3fC3fT2f> m_worldVertices;
+
     Triangles m_triangles;
     Texture* m_texture;
     BlendFunc m_blendFunc = BlendFunc::DISABLE;
@@ -32,6 +32,14 @@ public:
 
     void setBufferData(const void* data, size_t size, size_t offset);
 
+    /**
+     * @brief Append data to a buffer created with BufferUsage::STREAM
+     *
+     * @return Byte offset of the data in the buffer, a multiple of alignment,
+     *         SIZE_MAX if the buffer is full for this frame
+     */
+    size_t streamData(const void* data, size_t size, size_t alignment);
+
 private:
     VertexBufferHandle m_handle;
     VertexBufferInfoHandle m_vertexBufferInfoHandle;
@@ -43,6 +43,8 @@ public:
 
     virtual void destroyProgram(ProgramHandle handle) = 0;
 
+    virtual void destroyRenderPrimitive(RenderPrimitiveHandle handle) = 0;
+
     virtual void bindPipeline(const PipelineState& state) = 0;
 
     virtual void bindRenderPrimitive(RenderPrimitiveHandle rph) = 0;
@@ -53,6 +55,28 @@ public:
     virtual void updateIndexBufferData(IndexBufferHandle handle, const void* data,
                                        size_t size, size_t offset) = 0;
 
+    /**
+     * @brief Append data to a buffer created with BufferUsage::STREAM
+     *
+     * The data stays valid until the end of the frame and doesn't overwrite
+     * data the GPU may still be reading. The buffer must be large enough for
+     * all the data streamed to it in a frame.
+     *
+     * @param size Size of the data in bytes
+     * @param alignment Alignment of the returned offset
+     * @return Byte offset of the data in the buffer, SIZE_MAX if it doesn't fit
+     */
+    virtual size_t streamBufferData(VertexBufferHandle handle, const void* data, size_t size,
+                                    size_t alignment) = 0;
+
+    virtual size_t streamIndexBufferData(IndexBufferHandle handle, const void* data,
+                                         size_t size) = 0;
+
+    /**
+     * @brief Called once the frame is submitted, recycles the stream buffers
+     */
+    virtual void endFrame() = 0;
+
     virtual void updateTextureImage(TextureHandle handle, uint8_t level, uint32_t xoffset,
                                     uint32_t yoffset, uint32_t zoffset, uint32_t width,
                                     uint32_t height, uint32_t depth,
@@ -62,8 +86,12 @@ public:
 
     virtual void getActiveUniforms(ProgramHandle handle, UniformInfoMap& infoMap) = 0;
 
+    /**
+     * @param indexOffset Byte offset of the first index in the index buffer
+     * @param baseVertex Value added to every index
+     */
     virtual void draw(PipelineState state, RenderPrimitiveHandle rph, const uint32_t indexOffset,
-                      const uint32_t indexCount) = 0;
+                      const uint32_t indexCount, const int32_t baseVertex) = 0;
 };
 
 } // namespace ocf::backend
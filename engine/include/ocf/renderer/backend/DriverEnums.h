@@ -50,6 +50,7 @@ enum class ElementType : uint8_t {
 enum class BufferUsage : uint8_t {
     STATIC,
     DYNAMIC,
+    STREAM,     //!< Rewritten every frame, through Driver::streamBufferData()
 };
 
 struct Attribute {
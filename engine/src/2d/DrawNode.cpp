@@ -87,8 +87,9 @@ void DrawNode::initRenderCommand(CustomCommand& command, ProgramType programType
     vb->createBuffer();
     vb->setBufferData(m_vertexBuffer.data(), VERTEX_BUFFER_SIZE, 0);
 
-    IndexBuffer* ib =
-        IndexBuffer::create(IndexBuffer::IndexType::USHORT, INITIAL_INDEX_BUFFER_SIZE);
+    IndexBuffer* ib = IndexBuffer::create(IndexBuffer::IndexType::USHORT,
+                                          INITIAL_INDEX_BUFFER_SIZE,
+                                          IndexBuffer::BufferUsage::DYNAMIC);
     ib->createBuffer();
     ib->setBufferData(m_indexBuffer.data(), INDEX_BUFFER_SIZE, 0);
 
@@ -245,7 +245,6 @@ FontFNT::FontFNT(Ref<BMFontConfiguration> config)
 
 FontFNT::~FontFNT()
 {
-    m_pConfiguration->release();
 }
 
 FontAtlas* FontFNT::createFontAtlas()
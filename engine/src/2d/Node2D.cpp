@@ -18,6 +18,7 @@ Node2D::Node2D()
     , m_ignoreAnchorPointForPosition(false)
     , m_transformDirty(true)
     , m_transformUpdated(true)
+    , m_modelViewUpdated(true)
     , m_contentSizeDirty(true)
 {
 }
@@ -196,7 +197,8 @@ uint32_t Node2D::processParentFlag(const mat4& parentTransform, uint32_t parentF
     flags |= (m_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0);
     flags |= (m_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
 
-    if (flags & FLAGS_TRANSFORM_DIRTY) {
+    m_modelViewUpdated = (flags & FLAGS_TRANSFORM_DIRTY) != 0;
+    if (m_modelViewUpdated) {
         m_modelVewTransform = this->transform(parentTransform);
     }
 
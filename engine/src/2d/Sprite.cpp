@@ -54,6 +54,8 @@ Sprite::Sprite()
     , m_material(nullptr)
     , m_blendFunc(BlendFunc::DISABLE)
 {
+    // Most sprites don't move every frame
+    m_trianglesCommand.setCachingWorldVertices(true);
 }
 
 Sprite::~Sprite()
@@ -128,6 +130,8 @@ void Sprite::draw(Renderer* renderer, const math::mat4& transform)
     setMVPMarixUniform();
 
     m_trianglesCommand.init(m_globalZOrder, m_texture.ptr(), m_blendFunc, m_triangles, transform);
+    m_trianglesCommand.setTransformUnchanged(!m_isDirty && !m_modelViewUpdated);
+    m_isDirty = false;
 
     renderer->addCommand(&m_trianglesCommand);
 }
@@ -183,6 +187,8 @@ void Sprite::updatePolygon()
     m_triangles.vertexCount = 4;
     m_triangles.indices = indices;
     m_triangles.indexCount = 6;
+
+    m_isDirty = true;
 }
 
 void Sprite::setTextureRect(const math::Rect& rect, const math::vec2& size)
@@ -235,12 +241,14 @@ void Sprite::flipX()
 {
     std::swap(m_quad.topLeft.texCoord, m_quad.topRight.texCoord);
     std::swap(m_quad.bottomLeft.texCoord, m_quad.bottomRight.texCoord);
+    m_isDirty = true;
 }
 
 void Sprite::flipY()
 {
     std::swap(m_quad.topLeft.texCoord, m_quad.bottomLeft.texCoord);
     std::swap(m_quad.topRight.texCoord, m_quad.bottomRight.texCoord);
+    m_isDirty = true;
 }
 
 void Sprite::setMVPMarixUniform()
@@ -14,14 +14,13 @@ static ALCcontext* s_pALContext = nullptr;
 
 AudioEngineImpl::AudioEngineImpl()
     : m_alSources()
-    , m_currentAudioID(0)
 {
 }
 
 AudioEngineImpl::~AudioEngineImpl()
 {
-    for (auto&& player : m_audioPlayers) {
-        player.second->destroy();
+    for (AudioPlayer* player : m_audioPlayers) {
+        player->destroy();
     }
 
     if (s_pALContext != nullptr) {
@@ -82,10 +81,7 @@ bool AudioEngineImpl::init()
 
 void AudioEngineImpl::setVolume(AUDIO_ID audioID, float volume)
 {
-    auto iter = m_audioPlayers.find(audioID);
-    if (iter != m_audioPlayers.end()) {
-        AudioPlayer* player = iter->second;
-
+    if (AudioPlayer* player = findPlayer(audioID)) {
         alSourcef(player->m_alSource, AL_GAIN, volume);
 
         ALenum error = alGetError();
@@ -97,10 +93,7 @@ void AudioEngineImpl::setVolume(AUDIO_ID audioID, float volume)
 
 void AudioEngineImpl::setLoop(AUDIO_ID audioID, bool loop)
 {
-    auto iter = m_audioPlayers.find(audioID);
-    if (iter != m_audioPlayers.end()) {
-        AudioPlayer* player = iter->second;
-
+    if (AudioPlayer* player = findPlayer(audioID)) {
         if (player->m_streamingSource) {
             player->setLoop(loop);
         }
@@ -142,26 +135,24 @@ AUDIO_ID AudioEngineImpl::play2d(std::string_view fileFullPath, bool loop, float
     }
 
     pAudioPlayer->setCache(pAudioCache);
-    m_audioPlayers.emplace(++m_currentAudioID, pAudioPlayer);
+    const AudioPlayerMap::Key key = m_audioPlayers.insert(pAudioPlayer);
 
     pAudioPlayer->play();
 
-    return m_currentAudioID;
+    return static_cast<AUDIO_ID>(key.getId());
 }
 
 void AudioEngineImpl::stop(AUDIO_ID audioID)
 {
-    auto iter = m_audioPlayers.find(audioID);
-    if (iter != m_audioPlayers.end()) {
-        AudioPlayer* player = iter->second;
+    if (AudioPlayer* player = findPlayer(audioID)) {
         player->destroy();
     }
 }
 
 void AudioEngineImpl::stopAll()
 {
-    for (auto&& player : m_audioPlayers) {
-        player.second->destroy();
+    for (AudioPlayer* player : m_audioPlayers) {
+        player->destroy();
     }
 
     updatePlayers(true);
@@ -171,10 +162,7 @@ bool AudioEngineImpl::pause(AUDIO_ID audioID)
 {
     bool result = false;
 
-    auto iter = m_audioPlayers.find(audioID);
-    if (iter != m_audioPlayers.end()) {
-        AudioPlayer* player = iter->second;
-
+    if (AudioPlayer* player = findPlayer(audioID)) {
         alSourcePause(player->m_alSource);
 
         ALenum error = alGetError();
@@ -193,10 +181,7 @@ bool AudioEngineImpl::resume(AUDIO_ID audioID)
 {
     bool result = false;
 
-    auto iter = m_audioPlayers.find(audioID);
-    if (iter != m_audioPlayers.end()) {
-        AudioPlayer* player = iter->second;
-
+    if (AudioPlayer* player = findPlayer(audioID)) {
         alSourcePlay(player->m_alSource);
 
         ALenum error = alGetError();
@@ -236,18 +221,19 @@ void AudioEngineImpl::updatePlayers(bool /* forStop */)
     AudioPlayer* player;
     ALuint alSource;
 
-    for (auto iter = m_audioPlayers.begin(); iter != m_audioPlayers.end();) {
-        player = iter->second;
+    // Erasing moves the last player to the current position
+    for (size_t i = 0; i < m_audioPlayers.size();) {
+        player = m_audioPlayers[i];
         alSource = player->m_alSource;
 
         if (player->m_removeByAudioEngine) {
 
-            iter = m_audioPlayers.erase(iter);
+            m_audioPlayers.erase(m_audioPlayers.getKey(i));
             delete player;
             m_unusedSourcesPool.push(alSource);
         }
         else {
-            ++iter;
+            ++i;
         }
     }
 }
@@ -259,13 +245,20 @@ void AudioEngineImpl::uncache(std::string_view filePath)
 
 void AudioEngineImpl::unchacheAll()
 {
-    for (auto&& player : m_audioPlayers) {
-        player.second->setCache(nullptr);
+    for (AudioPlayer* player : m_audioPlayers) {
+        player->setCache(nullptr);
     }
 
     m_audioPlayers.clear();
 }
 
+AudioPlayer* AudioEngineImpl::findPlayer(AUDIO_ID audioID)
+{
+    AudioPlayer** player =
+        m_audioPlayers.get(AudioPlayerMap::Key::fromId(static_cast<uint32_t>(audioID)));
+    return player ? *player : nullptr;
+}
+
 ALuint AudioEngineImpl::findSource()
 {
     ALuint sourceId = static_cast<ALuint>(AL_INVALID);
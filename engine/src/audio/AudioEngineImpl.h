@@ -1,9 +1,9 @@
 #pragma once
 #include <map>
-#include <unordered_map>
 #include <memory>
 #include <queue>
 #include "ocf/audio/AudioEngine.h"
+#include "ocf/core/SlotMap.h"
 #include "audio/AudioPlayer.h"
 #include "audio/AudioCache.h"
 
@@ -34,13 +34,14 @@ public:
 
 private:
     ALuint findSource();
+    AudioPlayer* findPlayer(AUDIO_ID audioID);
 
     ALuint m_alSources[AUDIO_SOURCE_MAX];
     std::queue<ALuint> m_unusedSourcesPool;
     std::map<std::string, std::unique_ptr<AudioCache>> m_audioCaches;
-    std::unordered_map<AUDIO_ID, AudioPlayer*> m_audioPlayers;
-
-    AUDIO_ID m_currentAudioID;
+    // Audio ids are the keys of the players, so ids of removed players don't resolve
+    using AudioPlayerMap = SlotMap<AudioPlayer*, 16>;
+    AudioPlayerMap m_audioPlayers;
 };
 
 } // namespace ocf
\ No newline at end of file
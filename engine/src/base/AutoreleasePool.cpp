@@ -0,0 +1,44 @@
+#include "ocf/base/AutoreleasePool.h"
+
+#include "ocf/base/Object.h"
+
+namespace ocf {
+
+AutoreleasePool& AutoreleasePool::getInstance()
+{
+    static AutoreleasePool instance;
+    return instance;
+}
+
+AutoreleasePool::~AutoreleasePool()
+{
+    drain();
+}
+
+void AutoreleasePool::addObject(Object* object)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_objects.push_back(object);
+}
+
+void AutoreleasePool::drain()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_draining.swap(m_objects);
+    }
+
+    // Released without the lock, destructors may autorelease other objects
+    for (Object* object : m_draining) {
+        object->release();
+    }
+    m_draining.clear();
+}
+
+size_t AutoreleasePool::getObjectCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_objects.size();
+}
+
+} // namespace ocf
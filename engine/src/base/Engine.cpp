@@ -13,11 +13,13 @@
 #include "ocf/2d/FontManager.h"
 #include "ocf/2d/Label.h"
 #include "ocf/audio/AudioEngine.h"
+#include "ocf/base/AutoreleasePool.h"
 #include "ocf/base/Camera.h"
 #include "ocf/base/Scene.h"
 #include "ocf/base/Macros.h"
 #include "ocf/core/EventDispatcher.h"
 #include "ocf/core/FileUtils.h"
+#include "ocf/core/FrameAllocator.h"
 #include "ocf/core/Logger.h"
 #include "ocf/core/job/JobSystem.h"
 #include "ocf/input/Input.h"
@@ -33,6 +35,14 @@ using namespace backend;
 
 Engine* Engine::s_sheredEngine = nullptr;
 
+namespace {
+job::JobSystemConfig s_jobSystemConfig;
+
+// Transient data of a frame, kept valid during the next frame too
+constexpr size_t FRAME_ALLOCATOR_SIZE = 4 * 1024 * 1024;
+constexpr uint32_t FRAME_ALLOCATOR_FRAME_COUNT = 2;
+} // namespace
+
 Engine* Engine::getInstance()
 {
     if (s_sheredEngine == nullptr) {
@@ -48,6 +58,11 @@ void Engine::destroyInstance()
     OCF_SAFE_DELETE(s_sheredEngine);
 }
 
+void Engine::setJobSystemConfig(const job::JobSystemConfig& config)
+{
+    s_jobSystemConfig = config;
+}
+
 void Engine::mainLoop()
 {
     if (m_cleanupInNextLoop) {
@@ -55,8 +70,10 @@ void Engine::mainLoop()
         cleanup();
     }
     else {
+        m_frameAllocator->nextFrame();
         update();
         draw();
+        AutoreleasePool::getInstance().drain();
     }
 }
 
@@ -67,6 +84,10 @@ void Engine::exit()
 
 void Engine::cleanup()
 {
+#if defined(OCF_ALLOCATOR_TRACKING)
+    AllocatorTracker::logStats();
+#endif
+
     OCF_SAFE_DELETE(m_fpsLabel);
     OCF_SAFE_DELETE(m_drawCallLabel);
     OCF_SAFE_DELETE(m_drawVertexLabel);
@@ -79,10 +100,14 @@ void Engine::cleanup()
 
     OCF_SAFE_DELETE(m_eventDispatcher);
 
+    OCF_SAFE_DELETE(m_frameAllocator);
+
     FileUtils::destroyInstance();
     ProgramManager::destroyInstance();
     FontManager::release();
 
+    AutoreleasePool::getInstance().drain();
+
     job::JobSystem::getInstance().shutdown();
 
     AudioEngine::end();
@@ -176,16 +201,16 @@ bool Engine::init()
 
     m_eventDispatcher = new EventDispatcher();
 
+    m_frameAllocator =
+        new FrameAllocator("FrameAllocator", FRAME_ALLOCATOR_SIZE, FRAME_ALLOCATOR_FRAME_COUNT);
+
     // Setup Logger
     auto consoleAppender = std::make_unique<ConsoleAppender>();
     Logger::getInstance().addAppender(std::move(consoleAppender));
     Logger::getInstance().setLogLevel(LogLevel::Debug);
 
     // Initialize Job System
-    job::JobSystemConfig config;
-    config.numWorkers = 4;
-    config.maxJobs = 512;
-    job::JobSystem::getInstance().initialize(config);
+    job::JobSystem::getInstance().initialize(s_jobSystemConfig);
 
     return true;
 }
@@ -1,12 +1,16 @@
 #include "ocf/base/Object.h"
 
+#include "ocf/base/AutoreleasePool.h"
+
+#include <assert.h>
+
 namespace ocf {
 
+static std::atomic<unsigned int> s_objectCount{0};
+
 Object::Object()
-    : m_referenceCount(0)
+    : m_id(s_objectCount.fetch_add(1, std::memory_order_relaxed) + 1)
 {
-    static unsigned int objectCount = 0;
-    m_id = ++objectCount;
 }
 
 Object::~Object()
@@ -20,20 +24,25 @@ unsigned int Object::getID() const
 
 void Object::retain()
 {
-    m_referenceCount++;
+    // Taking a reference only requires an existing one, no ordering needed
+    m_referenceCount.fetch_add(1, std::memory_order_relaxed);
 }
 
 void Object::release()
 {
-    m_referenceCount--;
+    // Orders every access of other owners before the deletion
+    const unsigned int count = m_referenceCount.fetch_sub(1, std::memory_order_acq_rel);
+    assert(count > 0);
 
-    if (m_referenceCount == 0) {
+    if (count == 1) {
         delete this;
     }
 }
 
 void Object::autorelease()
 {
+    retain();
+    AutoreleasePool::getInstance().addObject(this);
 }
 
 } // namespace ocf
@@ -1,5 +1,10 @@
 #include "ocf/core/Allocator.h"
 
+#include "platform/PlatformMacros.h"
+
+#include <algorithm>
+#include <cstring>
+
 namespace ocf {
 
 FreeList::FreeList(void* begin, void* end, size_t elementSize, size_t alignment, size_t offset)
@@ -39,4 +44,276 @@ FreeList::Node* FreeList::init(void* begin, void* end, size_t elementSize, size_
     return head;
 }
 
+AtomicFreeList::AtomicFreeList(void* begin, void* end, size_t elementSize, size_t alignment,
+                               size_t offset)
+    : m_begin(begin)
+    , m_end(end)
+{
+    m_head.store(init(begin, end, elementSize, alignment, offset), std::memory_order_relaxed);
+}
+
+uint64_t AtomicFreeList::init(void* begin, void* end, size_t elementSize, size_t alignment,
+                              size_t offset)
+{
+    assert(alignment >= alignof(Node));
+    assert(uintptr_t(end) - uintptr_t(begin) < EMPTY);
+
+    void* alignedBegin = pointermath::align(begin, alignment, offset);
+    void* alignedFirst = pointermath::align(pointermath::add(alignedBegin, elementSize), alignment, offset);
+    assert(alignedBegin >= begin && alignedBegin < end);
+    assert(alignedFirst >= begin && alignedFirst < end && alignedFirst > alignedBegin);
+
+    size_t stride = uintptr_t(alignedFirst) - uintptr_t(alignedBegin);
+    size_t count = (uintptr_t(end) - uintptr_t(alignedBegin)) / stride;
+
+    // link the elements, the last one terminates the list
+    Node* current = static_cast<Node*>(alignedBegin);
+    for (size_t i = 1; i < count; i++) {
+        Node* next = pointermath::add(current, stride);
+        new (current) Node{{next}};
+        current = next;
+    }
+    new (current) Node{{nullptr}};
+
+    return pack(uint32_t(uintptr_t(alignedBegin) - uintptr_t(begin)), 0);
+}
+
+namespace TrackingPolicy {
+
+Tracked::Tracked(const char* name, void* base, size_t size)
+{
+    m_stats.name = name ? name : "Unnamed";
+    m_stats.capacity = size;
+    AllocatorTracker::add(this);
+}
+
+Tracked::~Tracked()
+{
+    AllocatorTracker::remove(this);
+}
+
+void Tracked::onAlloc(void* p, size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_sizes[p] = size;
+    m_stats.liveCount++;
+    m_stats.liveBytes += size;
+    m_stats.peakCount = std::max(m_stats.peakCount, m_stats.liveCount);
+    m_stats.peakBytes = std::max(m_stats.peakBytes, m_stats.liveBytes);
+    m_stats.allocationCount++;
+}
+
+void Tracked::onFailure(size_t)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_stats.failureCount++;
+}
+
+void Tracked::onFree(void* p)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    auto it = m_sizes.find(p);
+    if (it != m_sizes.end()) {
+        release(it);
+    }
+}
+
+void Tracked::onRewind(void* p)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (auto it = m_sizes.begin(); it != m_sizes.end();) {
+        auto current = it++;
+        if (current->first >= p) {
+            release(current);
+        }
+    }
+}
+
+void Tracked::onReset()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_sizes.clear();
+    m_stats.liveCount = 0;
+    m_stats.liveBytes = 0;
+}
+
+AllocatorStats Tracked::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_stats;
+}
+
+void Tracked::release(std::unordered_map<void*, size_t>::iterator it)
+{
+    m_stats.liveCount--;
+    m_stats.liveBytes -= it->second;
+    m_sizes.erase(it);
+}
+
+} // namespace TrackingPolicy
+
+namespace {
+
+std::mutex& getTrackerLock()
+{
+    static std::mutex s_lock;
+    return s_lock;
+}
+
+std::vector<const TrackingPolicy::Tracked*>& getTrackedAllocators()
+{
+    static std::vector<const TrackingPolicy::Tracked*> s_allocators;
+    return s_allocators;
+}
+
+} // namespace
+
+void AllocatorTracker::add(const TrackingPolicy::Tracked* tracked)
+{
+    std::lock_guard<std::mutex> lock(getTrackerLock());
+    getTrackedAllocators().push_back(tracked);
+}
+
+void AllocatorTracker::remove(const TrackingPolicy::Tracked* tracked)
+{
+    std::lock_guard<std::mutex> lock(getTrackerLock());
+    auto& allocators = getTrackedAllocators();
+    allocators.erase(std::remove(allocators.begin(), allocators.end(), tracked), allocators.end());
+}
+
+std::vector<AllocatorStats> AllocatorTracker::getStats()
+{
+    std::vector<AllocatorStats> result;
+
+    std::lock_guard<std::mutex> lock(getTrackerLock());
+    for (const TrackingPolicy::Tracked* tracked : getTrackedAllocators()) {
+        AllocatorStats stats = tracked->getStats();
+        auto it = std::find_if(result.begin(), result.end(), [&](const AllocatorStats& entry) {
+            return std::strcmp(entry.name, stats.name) == 0;
+        });
+        if (it == result.end()) {
+            result.push_back(stats);
+            continue;
+        }
+        // Peaks of different allocators may not coincide, their sum is an upper bound
+        it->capacity += stats.capacity;
+        it->liveCount += stats.liveCount;
+        it->liveBytes += stats.liveBytes;
+        it->peakCount += stats.peakCount;
+        it->peakBytes += stats.peakBytes;
+        it->allocationCount += stats.allocationCount;
+        it->failureCount += stats.failureCount;
+    }
+
+    std::sort(result.begin(), result.end(), [](const AllocatorStats& a, const AllocatorStats& b) {
+        return std::strcmp(a.name, b.name) < 0;
+    });
+    return result;
+}
+
+void AllocatorTracker::logStats()
+{
+    for (const AllocatorStats& stats : getStats()) {
+        OCF_LOG_INFO("{}: {} / {} bytes live in {} blocks, peak {} bytes in {} blocks, "
+                     "{} allocations, {} failures",
+                     stats.name, stats.liveBytes, stats.capacity, stats.liveCount,
+                     stats.peakBytes, stats.peakCount, stats.allocationCount,
+                     stats.failureCount);
+    }
+}
+
+namespace threadcache {
+
+namespace {
+
+struct Cache {
+    void* cache;
+    void (*flush)(void* cache, uint32_t index);
+};
+
+std::mutex& getCacheLock()
+{
+    static std::mutex s_lock;
+    return s_lock;
+}
+
+std::vector<Cache>& getCaches()
+{
+    static std::vector<Cache> s_caches;
+    return s_caches;
+}
+
+// Bit i is set while index i is held by a thread
+std::atomic<uint64_t> s_usedIndices{0};
+static_assert(MAX_THREADS <= 64, "s_usedIndices has one bit per index");
+
+uint32_t acquireIndex()
+{
+    uint64_t used = s_usedIndices.load(std::memory_order_relaxed);
+    for (;;) {
+        uint32_t index = 0;
+        while (index < MAX_THREADS && (used & (uint64_t(1) << index)) != 0) {
+            ++index;
+        }
+        if (index == MAX_THREADS) {
+            return MAX_THREADS;
+        }
+        if (s_usedIndices.compare_exchange_weak(used, used | (uint64_t(1) << index),
+                                                std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+            return index;
+        }
+    }
+}
+
+// Holds the index of a thread, flushes its caches and frees the index on exit
+struct ThreadIndex {
+    ThreadIndex()
+        : index(acquireIndex())
+    {
+    }
+
+    ~ThreadIndex()
+    {
+        if (index == MAX_THREADS) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(getCacheLock());
+            for (const Cache& cache : getCaches()) {
+                cache.flush(cache.cache, index);
+            }
+        }
+        // Release so that the next owner sees the flushed magazines
+        s_usedIndices.fetch_and(~(uint64_t(1) << index), std::memory_order_release);
+    }
+
+    uint32_t index;
+};
+
+} // namespace
+
+uint32_t getThreadIndex() noexcept
+{
+    static thread_local ThreadIndex s_index;
+    return s_index.index;
+}
+
+void registerCache(void* cache, void (*flush)(void* cache, uint32_t index))
+{
+    std::lock_guard<std::mutex> lock(getCacheLock());
+    getCaches().push_back({cache, flush});
+}
+
+void unregisterCache(void* cache)
+{
+    std::lock_guard<std::mutex> lock(getCacheLock());
+    std::vector<Cache>& caches = getCaches();
+    caches.erase(std::remove_if(caches.begin(), caches.end(),
+                                [cache](const Cache& c) { return c.cache == cache; }),
+                 caches.end());
+}
+
+} // namespace threadcache
+
 } // namespace ocf
@@ -0,0 +1,70 @@
+#include "ocf/core/FrameAllocator.h"
+
+#include "platform/PlatformMacros.h"
+
+#include <new>
+
+namespace ocf {
+
+FrameAllocator::FrameAllocator(const char* name, size_t sizePerFrame, uint32_t frameCount)
+    : m_name(name)
+    , m_sizePerFrame(sizePerFrame)
+{
+    assert(frameCount > 0);
+    m_frames.resize(frameCount);
+    for (Frame& frame : m_frames) {
+        frame.arena = std::make_unique<Arena>(name, sizePerFrame);
+    }
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    for (Frame& frame : m_frames) {
+        releaseOverflow(frame);
+    }
+}
+
+void* FrameAllocator::alloc(size_t size, size_t alignment)
+{
+    Frame& frame = m_frames[m_frameIndex];
+    void* p = frame.arena->alloc(size, alignment);
+    if (p != nullptr) {
+        return p;
+    }
+
+    if (!m_overflowReported) {
+        m_overflowReported = true;
+        OCF_LOG_WARN("{}: frame area of {} bytes exhausted, falling back to the heap", m_name,
+                     m_sizePerFrame);
+    }
+
+    p = ::operator new(size, std::align_val_t(alignment));
+    frame.overflow.push_back({p, alignment});
+    frame.overflowSize += size;
+    return p;
+}
+
+void FrameAllocator::nextFrame()
+{
+    m_frameIndex = (m_frameIndex + 1) % static_cast<uint32_t>(m_frames.size());
+
+    Frame& frame = m_frames[m_frameIndex];
+    frame.arena->reset();
+    releaseOverflow(frame);
+}
+
+size_t FrameAllocator::getAllocatedSize() const
+{
+    return m_frames[m_frameIndex].arena->getAllocator().getAllocatedSize();
+}
+
+void FrameAllocator::releaseOverflow(Frame& frame)
+{
+    for (const Overflow& overflow : frame.overflow) {
+        ::operator delete(overflow.block, std::align_val_t(overflow.alignment));
+    }
+    frame.overflow.clear();
+    frame.overflowSize = 0;
+}
+
+} // namespace ocf
@@ -0,0 +1,72 @@
+#include "ocf/core/job/EventCount.h"
+
+#include <climits>
+
+#if (OCF_TARGET_PLATFORM == OCF_PLATFORM_LINUX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ocf {
+namespace job {
+
+#if (OCF_TARGET_PLATFORM == OCF_PLATFORM_LINUX)
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex requires a lock-free 32-bit atomic");
+
+void EventCount::commitWait(Key key)
+{
+    uint32_t* address = reinterpret_cast<uint32_t*>(&m_epoch);
+    while (m_epoch.load(std::memory_order_acquire) == key) {
+        // Returns immediately if the epoch already moved on
+        syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void EventCount::wake(uint32_t count)
+{
+    m_epoch.fetch_add(1, std::memory_order_release);
+    int wakeCount = count > static_cast<uint32_t>(INT_MAX) ? INT_MAX : static_cast<int>(count);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_epoch), FUTEX_WAKE_PRIVATE, wakeCount,
+            nullptr, nullptr, 0);
+}
+
+#else
+
+void EventCount::commitWait(Key key)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this, key] {
+            return m_epoch.load(std::memory_order_acquire) != key;
+        });
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void EventCount::wake(uint32_t count)
+{
+    m_epoch.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders the epoch change with a waiter that checked it
+    // but has not started waiting yet
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+
+    if (count >= m_waiters.load(std::memory_order_relaxed)) {
+        m_condition.notify_all();
+        return;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        m_condition.notify_one();
+    }
+}
+
+#endif
+
+}  // namespace job
+}  // namespace ocf
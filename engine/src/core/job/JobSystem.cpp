@@ -2,9 +2,14 @@
 
 #include "platform/PlatformMacros.h"
 #include <algorithm>
+#include <iomanip>
 #include <random>
 #include <thread>
 
+#if (OCF_TARGET_PLATFORM == OCF_PLATFORM_LINUX)
+#include <sched.h>
+#endif
+
 namespace ocf {
 namespace job {
 
@@ -16,6 +21,12 @@ JobSystem& JobSystem::getInstance()
     return instance;
 }
 
+JobSystem::~JobSystem()
+{
+    // Workers reference the queues, stop them before any member is destroyed
+    shutdown();
+}
+
 void JobSystem::initialize(const JobSystemConfig& config)
 {
     if (m_initialized.load(std::memory_order_relaxed)) {
@@ -25,29 +36,64 @@ void JobSystem::initialize(const JobSystemConfig& config)
     // Determine number of workers
     uint32_t numWorkers = config.numWorkers;
     if (numWorkers == 0) {
-        unsigned int hwConcurrency = std::thread::hardware_concurrency();
-        hwConcurrency = (hwConcurrency == 0) ? 1 : hwConcurrency - 1;
-        numWorkers = std::max(1u, hwConcurrency);
+        // One core is left to the thread that submits most of the work
+        uint32_t coreCount = static_cast<uint32_t>(getAvailableCores().size());
+        numWorkers = std::max(1u, coreCount - 1);
     }
 
     // Initialize job pool
     m_maxJobs = config.maxJobs;
     m_jobs.resize(m_maxJobs);
-    m_jobAllocated = std::make_unique<std::atomic<bool>[]>(m_maxJobs);
     for (size_t i = 0; i < m_maxJobs; ++i) {
         m_jobs[i] = std::make_unique<Job>();
-        m_jobAllocated[i].store(false, std::memory_order_relaxed);
+    }
+    m_continuations.assign(m_maxJobs, Continuations{});
+    m_freeJobs.reset(m_maxJobs);
+
+    // A global queue never holds more jobs than the pool, so it can't fill up
+    size_t globalQueueCapacity = 1;
+    while (globalQueueCapacity < m_maxJobs) {
+        globalQueueCapacity <<= 1;
+    }
+    for (auto& queue : m_globalQueues) {
+        queue.reset(globalQueueCapacity);
     }
 
+    m_spinCount = config.spinCount;
+    m_profilingEnabled = config.enableProfiling;
+    m_timelineEnabled = config.enableTimeline;
+    m_timelineCapacity = config.timelineCapacity;
+    m_timelineOrigin = std::chrono::steady_clock::now();
+
     // Create workers
     m_workers.reserve(numWorkers);
     for (uint32_t i = 0; i < numWorkers; ++i) {
         m_workers.push_back(std::make_unique<Worker>(*this, i));
+        if (m_timelineEnabled) {
+            m_workers.back()->m_timeline.reserve(m_timelineCapacity);
+        }
     }
 
     // Start workers
+    std::vector<int32_t> cores;
+    if (config.pinWorkers) {
+        cores = getAvailableCores();
+        // Keep the reserved core free unless it is the only one
+        auto reserved = std::find(cores.begin(), cores.end(), config.reservedCore);
+        if (reserved != cores.end() && cores.size() > 1) {
+            cores.erase(reserved);
+        }
+    }
     for (auto& worker : m_workers) {
-        worker->start();
+        WorkerThreadConfig threadConfig;
+        if (!config.threadName.empty()) {
+            threadConfig.name = config.threadName + " " + std::to_string(worker->getId());
+        }
+        if (!cores.empty()) {
+            threadConfig.core = cores[worker->getId() % cores.size()];
+        }
+        threadConfig.stackSize = config.stackSize;
+        worker->start(threadConfig);
     }
 
     m_initialized.store(true, std::memory_order_release);
@@ -55,6 +101,30 @@ void JobSystem::initialize(const JobSystemConfig& config)
     OCF_LOG_DEBUG("JobSystem initialized with {} workers and max {} jobs", numWorkers, m_maxJobs);
 }
 
+std::vector<int32_t> JobSystem::getAvailableCores()
+{
+    std::vector<int32_t> cores;
+#if (OCF_TARGET_PLATFORM == OCF_PLATFORM_LINUX)
+    // The process may be restricted to a subset of the cores (taskset, cgroups)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        for (int32_t core = 0; core < CPU_SETSIZE; ++core) {
+            if (CPU_ISSET(core, &cpuSet)) {
+                cores.push_back(core);
+            }
+        }
+    }
+#endif
+    if (cores.empty()) {
+        uint32_t count = std::max(1u, std::thread::hardware_concurrency());
+        for (uint32_t core = 0; core < count; ++core) {
+            cores.push_back(static_cast<int32_t>(core));
+        }
+    }
+    return cores;
+}
+
 void JobSystem::shutdown()
 {
     if (!m_initialized.load(std::memory_order_relaxed)) {
@@ -74,7 +144,8 @@ void JobSystem::shutdown()
 
     // Clear job pool
     m_jobs.clear();
-    m_jobAllocated.reset();
+    m_continuations.clear();
+    m_freeJobs.reset(0);
     m_maxJobs = 0;
 
     m_shuttingDown.store(false, std::memory_order_relaxed);
@@ -98,13 +169,14 @@ JobHandle JobSystem::createJob(JobFunction function, void* data, JobPriority pri
     job->function = std::move(function);
     job->data = data;
     job->priority = priority;
-    job->parent = INVALID_JOB_HANDLE;
+    job->parent = Job::NO_PARENT;
     job->unfinishedJobs.store(1, std::memory_order_relaxed);
+    job->pendingDependencies.store(1, std::memory_order_relaxed);
+    m_continuations[index].count = 0;
     job->handle.id = index + 1;  // 1-based ID
     job->handle.generation =
         (m_generation.fetch_add(1, std::memory_order_relaxed)) % UINT32_MAX + 1; // Avoid 0 generation
 
-    // @TODO: Handle priority (for now, all jobs are treated equally)
     return job->handle;
 }
 
@@ -116,13 +188,8 @@ JobHandle JobSystem::createJobAsChild(JobHandle parent, JobFunction function, vo
     }
 
     // Find parent job
-    uint32_t parentIndex = parent.id - 1;
-    if (parentIndex >= m_jobs.size()) {
-        return INVALID_JOB_HANDLE;
-    }
-
-    Job* parentJob = m_jobs[parentIndex].get();
-    if (parentJob->handle != parent) {
+    Job* parentJob = resolveJob(parent);
+    if (!parentJob) {
         return INVALID_JOB_HANDLE;  // Parent job has been recycled
     }
 
@@ -139,11 +206,44 @@ JobHandle JobSystem::createJobAsChild(JobHandle parent, JobFunction function, vo
 
     // Set parent reference
     uint32_t childIndex = childHandle.id - 1;
-    m_jobs[childIndex]->parent = parent;
+    m_jobs[childIndex]->parent = parent.id - 1;
 
     return childHandle;
 }
 
+JobHandle JobSystem::createContinuation(JobHandle antecedent, JobFunction function, void* data,
+                                        JobPriority priority)
+{
+    if (!resolveJob(antecedent)) {
+        return INVALID_JOB_HANDLE;
+    }
+
+    JobHandle handle = createJob(std::move(function), data, priority);
+    if (handle.isValid() && !addContinuation(antecedent, handle)) {
+        freeJob(handle.id - 1);
+        return INVALID_JOB_HANDLE;
+    }
+    return handle;
+}
+
+bool JobSystem::addContinuation(JobHandle antecedent, JobHandle continuation)
+{
+    Job* job = resolveJob(antecedent);
+    Job* next = resolveJob(continuation);
+    if (!job || !next || job == next) {
+        return false;
+    }
+
+    Continuations& continuations = m_continuations[antecedent.id - 1];
+    if (continuations.count >= MAX_JOB_CONTINUATIONS) {
+        return false;
+    }
+
+    next->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+    continuations.jobs[continuations.count++] = continuation.id - 1;
+    return true;
+}
+
 void JobSystem::run(JobHandle handle)
 {
     if (!handle.isValid() || m_shuttingDown.load(std::memory_order_relaxed)) {
@@ -157,16 +257,31 @@ void JobSystem::run(JobHandle handle)
 
     m_pendingJobs.fetch_add(1, std::memory_order_relaxed);
 
+    // A job waiting for antecedents is scheduled by the last one to finish
+    Job* job = m_jobs[index].get();
+    if (job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    schedule(index);
+}
+
+void JobSystem::schedule(uint32_t index)
+{
+    JobPriority priority = m_jobs[index]->priority;
+
     // Try to push to current worker's queue if we're on a worker thread
     uint32_t workerId = getCurrentWorkerId();
     if (workerId < m_workers.size()) {
-        if (m_workers[workerId]->pushJob(index)) {
+        if (m_workers[workerId]->pushJob(index, priority)) {
+            // Let a parked worker steal it
+            wakeWorkers(1);
             return;
         }
     }
 
     // Push to global queue
-    if (!m_globalQueue.push(index)) {
+    if (!m_globalQueues[static_cast<size_t>(priority)].push(index)) {
         // Queue full, execute synchronously
         Job* job = m_jobs[index].get();
         if (job->function) {
@@ -176,8 +291,8 @@ void JobSystem::run(JobHandle handle)
         return;
     }
 
-    // Wake up workers
-    wakeAllWorkers();
+    // Wake up a worker for the new job
+    wakeWorkers(1);
 }
 
 void JobSystem::runAndWait(JobHandle handle)
@@ -229,11 +344,88 @@ bool JobSystem::isComplete(JobHandle handle) const
     return job->unfinishedJobs.load(std::memory_order_acquire) == 0;
 }
 
+Job* JobSystem::resolveJob(JobHandle handle)
+{
+    if (!handle.isValid()) {
+        return nullptr;
+    }
+
+    uint32_t index = handle.id - 1;
+    if (index >= m_jobs.size()) {
+        return nullptr;
+    }
+
+    Job* job = m_jobs[index].get();
+    return job->handle == handle ? job : nullptr;
+}
+
 uint32_t JobSystem::getCurrentWorkerId() const
 {
     return s_currentWorkerId;
 }
 
+struct JobSystem::ParallelForContext {
+    RangeFunction function;
+    void* context;
+    uint32_t grainSize;
+    JobPriority priority;
+    JobHandle root;
+};
+
+uint32_t JobSystem::getGrainSize(uint32_t count, uint32_t grainSize) const
+{
+    const uint32_t numThreads = getWorkerCount() + 1;
+    const uint32_t maxSplits = numThreads * PARALLEL_SPLITS_PER_THREAD;
+    const uint32_t minGrainSize = (count + maxSplits - 1) / maxSplits;
+    return std::max({grainSize, minGrainSize, 1u});
+}
+
+void JobSystem::parallelForImpl(uint32_t begin, uint32_t end, uint32_t grainSize,
+                                JobPriority priority, RangeFunction function, void* context)
+{
+    if (begin >= end) {
+        return;
+    }
+
+    const uint32_t grain = getGrainSize(end - begin, grainSize);
+    if (!isInitialized() || end - begin <= grain) {
+        function(context, begin, end);
+        return;
+    }
+
+    // The root job only anchors the children so that a single wait covers them all
+    ParallelForContext ctx{function, context, grain, priority, INVALID_JOB_HANDLE};
+    ctx.root = createJob([](void*) {}, nullptr, priority);
+    if (!ctx.root.isValid()) {
+        function(context, begin, end);
+        return;
+    }
+
+    splitRange(ctx, begin, end);
+    runAndWait(ctx.root);
+}
+
+void JobSystem::splitRange(ParallelForContext& context, uint32_t begin, uint32_t end)
+{
+    // Hand off the upper half to another job until the range is small enough
+    while (end - begin > context.grainSize) {
+        uint32_t mid = begin + (end - begin) / 2;
+        JobHandle child = createJobAsChild(
+            context.root,
+            [this, mid, end](void* data) {
+                splitRange(*static_cast<ParallelForContext*>(data), mid, end);
+            },
+            &context, context.priority);
+        if (!child.isValid()) {
+            break;  // Pool exhausted, process the rest here
+        }
+        run(child);
+        end = mid;
+    }
+
+    context.function(context.context, begin, end);
+}
+
 Job* JobSystem::getJob(uint32_t index)
 {
     if (index >= m_jobs.size()) {
@@ -247,24 +439,32 @@ void JobSystem::finishJob(Job* job)
     int32_t remaining = job->unfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) - 1;
 
     if (remaining == 0) {
-        // Job is complete, check parent
+        // Job is complete, schedule continuations whose antecedents are all done
         uint32_t jobIndex = job->handle.id - 1;
-        if (job->parent.isValid()) {
-            uint32_t parentIndex = job->parent.id - 1;
-            if (parentIndex < m_jobs.size()) {
-                finishJob(m_jobs[parentIndex].get());
+        const Continuations& continuations = m_continuations[jobIndex];
+        for (uint8_t i = 0; i < continuations.count; ++i) {
+            uint32_t continuationIndex = continuations.jobs[i];
+            Job* continuation = m_jobs[continuationIndex].get();
+            if (continuation->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                schedule(continuationIndex);
             }
         }
 
+        // Check parent
+        if (job->parent < m_jobs.size()) {
+            finishJob(m_jobs[job->parent].get());
+        }
+
         // Free the job slot
         freeJob(jobIndex);
 
         // Decrement pending count
-        m_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+        m_pendingJobs.fetch_sub(1, std::memory_order_release);
     }
 }
 
-std::optional<uint32_t> JobSystem::stealFromOthers(uint32_t currentWorkerId)
+std::optional<uint32_t> JobSystem::stealFromOthers(uint32_t currentWorkerId,
+                                                   JobPriority priority)
 {
     size_t numWorkers = m_workers.size();
     if (numWorkers <= 1) {
@@ -285,7 +485,10 @@ std::optional<uint32_t> JobSystem::stealFromOthers(uint32_t currentWorkerId)
             continue;
         }
 
-        auto stolen = m_workers[victimIndex]->steal();
+        auto stolen = m_workers[victimIndex]->steal(priority);
+        if (m_profilingEnabled && currentWorkerId < numWorkers) {
+            m_workers[currentWorkerId]->recordStealAttempt(stolen.has_value());
+        }
         if (stolen.has_value()) {
             return stolen;
         }
@@ -294,53 +497,123 @@ std::optional<uint32_t> JobSystem::stealFromOthers(uint32_t currentWorkerId)
     return std::nullopt;
 }
 
-std::optional<uint32_t> JobSystem::popFromGlobalQueue()
+std::optional<uint32_t> JobSystem::popFromGlobalQueue(JobPriority priority)
+{
+    return m_globalQueues[static_cast<size_t>(priority)].pop();
+}
+
+void JobSystem::wakeWorkers(uint32_t count)
 {
-    return m_globalQueue.steal();
+    m_workAvailable.notify(count);
 }
 
 void JobSystem::wakeAllWorkers()
+{
+    m_workAvailable.notifyAll();
+}
+
+WorkerStats JobSystem::getWorkerStats(uint32_t workerId) const
+{
+    if (workerId >= m_workers.size()) {
+        return {};
+    }
+    return m_workers[workerId]->getStats();
+}
+
+void JobSystem::resetStats()
 {
     for (auto& worker : m_workers) {
-        worker->wakeUp();
+        worker->resetStats();
     }
+    m_timelineOrigin = std::chrono::steady_clock::now();
 }
 
-uint32_t JobSystem::allocateJob()
+void JobSystem::logStats() const
 {
-    size_t poolSize = m_maxJobs;
-    uint32_t startIndex = m_nextJobIndex.fetch_add(1, std::memory_order_relaxed) %
-                          static_cast<uint32_t>(poolSize);
+    for (const auto& worker : m_workers) {
+        WorkerStats stats = worker->getStats();
+        OCF_LOG_INFO("Worker {}: {} jobs, {}/{} steals, {:.3f} ms idle, queue depth {} (max {})",
+                     worker->getId(), stats.jobsExecuted, stats.stealsSucceeded,
+                     stats.stealsAttempted, stats.idleTimeNs / 1.0e6, stats.queueDepth,
+                     stats.maxQueueDepth);
+    }
+}
 
-    for (size_t i = 0; i < poolSize; ++i) {
-        uint32_t index = (startIndex + static_cast<uint32_t>(i)) % static_cast<uint32_t>(poolSize);
-        bool expected = false;
-        if (m_jobAllocated[index].compare_exchange_strong(expected, true,
-                                                          std::memory_order_acq_rel)) {
-            return index;
+void JobSystem::writeChromeTrace(std::ostream& out) const
+{
+    static const char* const PRIORITY_NAMES[JOB_PRIORITY_COUNT] = {"Low", "Normal", "High",
+                                                                     "Critical"};
+
+    const std::ios_base::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&]() -> std::ostream& {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        return out;
+    };
+
+    for (const auto& worker : m_workers) {
+        const uint32_t tid = worker->getId();
+        separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid
+                    << ",\"args\":{\"name\":\"Worker " << tid << "\"}}";
+
+        // Timestamps are in microseconds
+        for (const TimelineEvent& event : worker->getTimeline()) {
+            separator() << "{\"name\":\"Job " << event.jobId << "\",\"cat\":\""
+                        << PRIORITY_NAMES[static_cast<size_t>(event.priority)]
+                        << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid
+                        << ",\"ts\":" << event.beginNs / 1000.0
+                        << ",\"dur\":" << (event.endNs - event.beginNs) / 1000.0 << "}";
         }
     }
 
-    return UINT32_MAX;  // Pool exhausted
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+int64_t JobSystem::getTimelineTime() const
+{
+    auto elapsed = std::chrono::steady_clock::now() - m_timelineOrigin;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+uint32_t JobSystem::allocateJob()
+{
+    uint32_t index = m_freeJobs.allocate();
+    if (index == JobFreeList::INVALID_INDEX) {
+        return UINT32_MAX;  // Pool exhausted
+    }
+    return index;
 }
 
 void JobSystem::freeJob(uint32_t index)
 {
     if (index < m_maxJobs) {
-        m_jobAllocated[index].store(false, std::memory_order_release);
+        // Release the callable's captures now rather than when the slot is reused
+        m_jobs[index]->function.reset();
+        m_freeJobs.free(index);
     }
 }
 
 void JobSystem::helpWithJob()
 {
-    // Try to get a job from global queue or steal
-    auto jobIndex = m_globalQueue.steal();
-    if (!jobIndex.has_value()) {
-        // Try stealing from workers
-        for (auto& worker : m_workers) {
-            jobIndex = worker->steal();
-            if (jobIndex.has_value()) {
-                break;
+    // Try to get a job from global queue or steal, highest priority first
+    std::optional<uint32_t> jobIndex;
+    for (size_t i = JOB_PRIORITY_COUNT; i-- > 0 && !jobIndex.has_value();) {
+        JobPriority priority = static_cast<JobPriority>(i);
+        jobIndex = m_globalQueues[i].pop();
+        if (!jobIndex.has_value()) {
+            // Try stealing from workers
+            for (auto& worker : m_workers) {
+                jobIndex = worker->steal(priority);
+                if (jobIndex.has_value()) {
+                    break;
+                }
             }
         }
     }
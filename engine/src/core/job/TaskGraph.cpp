@@ -0,0 +1,148 @@
+#include "ocf/core/job/TaskGraph.h"
+#include "ocf/core/job/JobSystem.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace ocf {
+namespace job {
+
+TaskGraph::TaskId TaskGraph::addTask(JobFunction function, void* data, JobPriority priority)
+{
+    Task task;
+    task.function = std::move(function);
+    task.data = data;
+    task.priority = priority;
+    m_tasks.push_back(std::move(task));
+    return static_cast<TaskId>(m_tasks.size() - 1);
+}
+
+void TaskGraph::addDependency(TaskId before, TaskId after)
+{
+    assert(before < m_tasks.size() && after < m_tasks.size() && before != after);
+    m_tasks[before].successors.push_back(after);
+}
+
+JobHandle TaskGraph::submit(JobSystem& jobSystem)
+{
+    m_runInline = false;
+    m_handles.clear();
+    m_relays.clear();
+
+    // Every job of the submission is a child of the root, so the root
+    // completes once the whole graph has completed
+    JobHandle root = jobSystem.createJob([](void*) {});
+    if (!root.isValid()) {
+        runInline();
+        return INVALID_JOB_HANDLE;
+    }
+
+    bool created = true;
+    for (TaskId id = 0; id < m_tasks.size() && created; ++id) {
+        JobHandle handle = jobSystem.createJobAsChild(
+            root, [this, id](void* data) { runTask(id, data); }, m_tasks[id].data,
+            m_tasks[id].priority);
+        created = handle.isValid();
+        if (created) {
+            m_handles.push_back(handle);
+        }
+    }
+
+    for (TaskId id = 0; id < m_handles.size() && created; ++id) {
+        const Task& task = m_tasks[id];
+        created = connect(jobSystem, root, m_handles[id], task.successors.data(),
+                          task.successors.size(), task.priority);
+    }
+
+    if (!created) {
+        // Pool exhausted, the jobs created so far still run but do nothing
+        m_runInline = true;
+        runInline();
+    }
+
+    for (JobHandle relay : m_relays) {
+        jobSystem.run(relay);
+    }
+    for (JobHandle handle : m_handles) {
+        jobSystem.run(handle);
+    }
+    jobSystem.run(root);
+
+    return root;
+}
+
+void TaskGraph::clear()
+{
+    m_tasks.clear();
+    m_handles.clear();
+    m_relays.clear();
+}
+
+void TaskGraph::runTask(TaskId id, void* data)
+{
+    if (!m_runInline) {
+        m_tasks[id].function(data);
+    }
+}
+
+bool TaskGraph::connect(JobSystem& jobSystem, JobHandle root, JobHandle antecedent,
+                        const TaskId* successors, size_t count, JobPriority priority)
+{
+    if (count <= MAX_JOB_CONTINUATIONS) {
+        for (size_t i = 0; i < count; ++i) {
+            jobSystem.addContinuation(antecedent, m_handles[successors[i]]);
+        }
+        return true;
+    }
+
+    // Too many successors for a single job, fan out through empty relay jobs
+    const size_t groupSize = (count + MAX_JOB_CONTINUATIONS - 1) / MAX_JOB_CONTINUATIONS;
+    for (size_t first = 0; first < count; first += groupSize) {
+        JobHandle relay = jobSystem.createJobAsChild(root, [](void*) {}, nullptr, priority);
+        if (!relay.isValid()) {
+            return false;
+        }
+        m_relays.push_back(relay);
+        jobSystem.addContinuation(antecedent, relay);
+
+        size_t groupCount = std::min(groupSize, count - first);
+        if (!connect(jobSystem, root, relay, successors + first, groupCount, priority)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TaskGraph::runInline()
+{
+    // Kahn's algorithm: run tasks once all their predecessors have run
+    std::vector<uint32_t> predecessors(m_tasks.size(), 0);
+    for (const Task& task : m_tasks) {
+        for (TaskId successor : task.successors) {
+            ++predecessors[successor];
+        }
+    }
+
+    std::vector<TaskId> ready;
+    for (TaskId id = 0; id < m_tasks.size(); ++id) {
+        if (predecessors[id] == 0) {
+            ready.push_back(id);
+        }
+    }
+
+    while (!ready.empty()) {
+        TaskId id = ready.back();
+        ready.pop_back();
+
+        Task& task = m_tasks[id];
+        task.function(task.data);
+        for (TaskId successor : task.successors) {
+            if (--predecessors[successor] == 0) {
+                ready.push_back(successor);
+            }
+        }
+    }
+}
+
+}  // namespace job
+}  // namespace ocf
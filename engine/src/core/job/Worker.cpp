@@ -1,7 +1,18 @@
 #include "ocf/core/job/Worker.h"
 #include "ocf/core/job/JobSystem.h"
 
+#include "platform/PlatformMacros.h"
+
+#include <algorithm>
 #include <chrono>
+#include <thread>
+
+#if (OCF_TARGET_PLATFORM == OCF_PLATFORM_LINUX)
+#include <climits>
+#include <sched.h>
+#elif (OCF_TARGET_PLATFORM == OCF_PLATFORM_WIN32)
+#include <windows.h>
+#endif
 
 namespace ocf {
 namespace job {
@@ -17,44 +28,80 @@ Worker::~Worker()
     stop();
 }
 
-void Worker::start()
+void Worker::start(const WorkerThreadConfig& config)
 {
+    m_threadConfig = config;
     m_shouldStop.store(false, std::memory_order_relaxed);
+
+#if (OCF_TARGET_PLATFORM == OCF_PLATFORM_LINUX)
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    if (config.stackSize > 0) {
+        pthread_attr_setstacksize(&attributes,
+                                  std::max(config.stackSize, static_cast<size_t>(PTHREAD_STACK_MIN)));
+    }
+    int result = pthread_create(
+        &m_thread, &attributes,
+        [](void* worker) -> void* {
+            static_cast<Worker*>(worker)->threadFunc();
+            return nullptr;
+        },
+        this);
+    pthread_attr_destroy(&attributes);
+
+    if (result != 0) {
+        OCF_LOG_ERROR("Failed to create worker thread {} (error {})", m_workerId, result);
+        return;
+    }
+    m_joinable = true;
+#else
+    if (config.stackSize > 0) {
+        OCF_LOG_WARN("Worker stack size is not supported on this platform, using the default");
+    }
     m_thread = std::thread(&Worker::threadFunc, this);
+#endif
+
     m_running.store(true, std::memory_order_relaxed);
 }
 
 void Worker::stop()
 {
     m_shouldStop.store(true, std::memory_order_release);
-    wakeUp();
+    m_jobSystem.wakeAllWorkers();
 
+#if (OCF_TARGET_PLATFORM == OCF_PLATFORM_LINUX)
+    if (m_joinable) {
+        pthread_join(m_thread, nullptr);
+        m_joinable = false;
+    }
+#else
     if (m_thread.joinable()) {
         m_thread.join();
     }
+#endif
 
     m_running.store(false, std::memory_order_relaxed);
 }
 
-bool Worker::pushJob(uint32_t jobIndex)
+bool Worker::pushJob(uint32_t jobIndex, JobPriority priority)
 {
-    return m_localQueue.push(jobIndex);
-}
+    bool pushed = m_localQueues[static_cast<size_t>(priority)].push(jobIndex);
 
-std::optional<uint32_t> Worker::steal()
-{
-    return m_localQueue.steal();
+    if (m_jobSystem.m_profilingEnabled) {
+        uint64_t depth = 0;
+        for (const auto& queue : m_localQueues) {
+            depth += queue.size();
+        }
+        if (depth > m_maxQueueDepth.load(std::memory_order_relaxed)) {
+            m_maxQueueDepth.store(depth, std::memory_order_relaxed);
+        }
+    }
+    return pushed;
 }
 
-void Worker::wakeUp()
+std::optional<uint32_t> Worker::steal(JobPriority priority)
 {
-    // Lock is required to ensure proper memory ordering when signaling
-    // the condition variable. Without the lock, the notify may be lost
-    // if the worker is between the predicate check and the actual wait.
-    {
-        std::lock_guard<std::mutex> lock(m_sleepMutex);
-    }
-    m_sleepCondition.notify_one();
+    return m_localQueues[static_cast<size_t>(priority)].steal();
 }
 
 void Worker::threadFunc()
@@ -62,43 +109,207 @@ void Worker::threadFunc()
     // Set the thread-local worker ID so JobSystem can identify which worker
     // thread is running
     JobSystem::s_currentWorkerId = m_workerId;
+    applyThreadConfig();
+
+    EventCount& workAvailable = m_jobSystem.m_workAvailable;
+    const uint32_t spinCount = m_jobSystem.m_spinCount;
+    const bool profiling = m_jobSystem.m_profilingEnabled;
+    uint32_t idleSpins = 0;
+    bool idle = false;
+    std::chrono::steady_clock::time_point idleStart;
 
     while (!m_shouldStop.load(std::memory_order_acquire)) {
         auto jobIndex = getJob();
 
-        if (jobIndex.has_value()) {
-            Job* job = m_jobSystem.getJob(jobIndex.value());
-            if (job && job->function) {
-                job->function(job->data);
-                m_jobSystem.finishJob(job);
+        if (!jobIndex.has_value()) {
+            if (profiling && !idle) {
+                idle = true;
+                idleStart = std::chrono::steady_clock::now();
+            }
+
+            // New work often arrives shortly, spin a little before parking
+            if (idleSpins < spinCount) {
+                ++idleSpins;
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Look for work once more after registering as a waiter, so a job
+            // submitted in between is either found here or wakes us up
+            EventCount::Key key = workAvailable.prepareWait();
+            if (m_shouldStop.load(std::memory_order_acquire)) {
+                workAvailable.cancelWait();
+                break;
             }
+            jobIndex = getJob();
+            if (!jobIndex.has_value()) {
+                workAvailable.commitWait(key);
+                idleSpins = 0;
+                continue;
+            }
+            workAvailable.cancelWait();
         }
-        else {
-            // No work available, sleep
-            std::unique_lock<std::mutex> lock(m_sleepMutex);
-            m_sleepCondition.wait_for(lock, std::chrono::milliseconds(1), [this] {
-                return m_shouldStop.load(std::memory_order_acquire) || !m_localQueue.empty();
-            });
+
+        idleSpins = 0;
+        if (idle) {
+            idle = false;
+            auto idleTime = std::chrono::steady_clock::now() - idleStart;
+            increment(m_idleTimeNs, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(idleTime).count()));
+        }
+        execute(jobIndex.value());
+    }
+}
+
+void Worker::applyThreadConfig()
+{
+#if (OCF_TARGET_PLATFORM == OCF_PLATFORM_LINUX)
+    if (!m_threadConfig.name.empty()) {
+        // Linux limits thread names to 15 characters
+        std::string name = m_threadConfig.name.substr(0, 15);
+        pthread_setname_np(pthread_self(), name.c_str());
+    }
+    if (m_threadConfig.core >= 0) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(m_threadConfig.core, &cpuSet);
+        int result = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+        if (result != 0) {
+            OCF_LOG_WARN("Failed to pin worker {} to core {} (error {})", m_workerId,
+                         m_threadConfig.core, result);
+        }
+    }
+#elif (OCF_TARGET_PLATFORM == OCF_PLATFORM_WIN32)
+    if (!m_threadConfig.name.empty()) {
+        std::wstring name(m_threadConfig.name.begin(), m_threadConfig.name.end());
+        SetThreadDescription(GetCurrentThread(), name.c_str());
+    }
+    if (m_threadConfig.core >= 0 && m_threadConfig.core < 64) {
+        if (SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << m_threadConfig.core) == 0) {
+            OCF_LOG_WARN("Failed to pin worker {} to core {}", m_workerId, m_threadConfig.core);
+        }
+    }
+#endif
+}
+
+void Worker::execute(uint32_t jobIndex)
+{
+    Job* job = m_jobSystem.getJob(jobIndex);
+    if (!job || !job->function) {
+        return;
+    }
+
+    if (!m_jobSystem.m_timelineEnabled) {
+        job->function(job->data);
+    }
+    else {
+        TimelineEvent event;
+        event.jobId = job->handle.id;
+        event.priority = job->priority;
+        event.beginNs = m_jobSystem.getTimelineTime();
+        job->function(job->data);
+        event.endNs = m_jobSystem.getTimelineTime();
+
+        if (m_timeline.size() < m_jobSystem.m_timelineCapacity) {
+            m_timeline.push_back(event);
         }
     }
+
+    // Record before finishing, so that the results are visible to whoever waits on the job
+    if (m_jobSystem.m_profilingEnabled) {
+        increment(m_jobsExecuted);
+    }
+    m_jobSystem.finishJob(job);
+}
+
+WorkerStats Worker::getStats() const
+{
+    WorkerStats stats;
+    stats.jobsExecuted = m_jobsExecuted.load(std::memory_order_relaxed);
+    stats.stealsAttempted = m_stealsAttempted.load(std::memory_order_relaxed);
+    stats.stealsSucceeded = m_stealsSucceeded.load(std::memory_order_relaxed);
+    stats.idleTimeNs = m_idleTimeNs.load(std::memory_order_relaxed);
+    stats.maxQueueDepth = static_cast<size_t>(m_maxQueueDepth.load(std::memory_order_relaxed));
+    for (const auto& queue : m_localQueues) {
+        stats.queueDepth += queue.size();
+    }
+    return stats;
+}
+
+void Worker::resetStats()
+{
+    m_jobsExecuted.store(0, std::memory_order_relaxed);
+    m_stealsAttempted.store(0, std::memory_order_relaxed);
+    m_stealsSucceeded.store(0, std::memory_order_relaxed);
+    m_idleTimeNs.store(0, std::memory_order_relaxed);
+    m_maxQueueDepth.store(0, std::memory_order_relaxed);
+    m_timeline.clear();
+}
+
+void Worker::recordStealAttempt(bool succeeded)
+{
+    increment(m_stealsAttempted);
+    if (succeeded) {
+        increment(m_stealsSucceeded);
+    }
+}
+
+void Worker::increment(std::atomic<uint64_t>& counter, uint64_t value)
+{
+    // Single writer, a plain load/store is enough and avoids a locked instruction
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
 }
 
 std::optional<uint32_t> Worker::getJob()
+{
+    // Give pending Low priority work a turn once enough higher priority jobs ran.
+    // Only our own and the global queue are checked here, Low jobs queued on
+    // other workers are picked up by their own starvation check.
+    if (m_jobsSinceLowPriority >= LOW_PRIORITY_STARVATION_LIMIT) {
+        auto job = m_localQueues[static_cast<size_t>(JobPriority::Low)].pop();
+        if (!job.has_value()) {
+            job = m_jobSystem.popFromGlobalQueue(JobPriority::Low);
+        }
+        if (job.has_value()) {
+            m_jobsSinceLowPriority = 0;
+            return job;
+        }
+    }
+
+    // Drain higher priorities first
+    for (size_t i = JOB_PRIORITY_COUNT; i-- > 0;) {
+        JobPriority priority = static_cast<JobPriority>(i);
+        auto job = getJob(priority);
+        if (job.has_value()) {
+            if (priority == JobPriority::Low) {
+                m_jobsSinceLowPriority = 0;
+            }
+            else if (m_jobsSinceLowPriority < LOW_PRIORITY_STARVATION_LIMIT) {
+                ++m_jobsSinceLowPriority;
+            }
+            return job;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<uint32_t> Worker::getJob(JobPriority priority)
 {
     // First try our own queue
-    auto job = m_localQueue.pop();
+    auto job = m_localQueues[static_cast<size_t>(priority)].pop();
     if (job.has_value()) {
         return job;
     }
 
     // Try the global queue
-    job = m_jobSystem.popFromGlobalQueue();
+    job = m_jobSystem.popFromGlobalQueue(priority);
     if (job.has_value()) {
         return job;
     }
 
     // Try to steal from other workers
-    return m_jobSystem.stealFromOthers(m_workerId);
+    return m_jobSystem.stealFromOthers(m_workerId, priority);
 }
 
 }  // namespace job
@@ -9,10 +9,10 @@ namespace ocf {
 
 using namespace backend;
 
-IndexBuffer* IndexBuffer::create(IndexType type, uint32_t indexCount)
+IndexBuffer* IndexBuffer::create(IndexType type, uint32_t indexCount, BufferUsage usage)
 {
     IndexBuffer* indexBuffer = new IndexBuffer();
-    if (indexBuffer->init(type, indexCount)) {
+    if (indexBuffer->init(type, indexCount, usage)) {
         return indexBuffer;
     }
 
@@ -24,6 +24,7 @@ IndexBuffer::IndexBuffer()
     : m_handle(0)
     , m_indexCount(0)
     , m_indexType(IndexType::USHORT)
+    , m_usage(BufferUsage::STATIC)
 {
 }
 
@@ -33,10 +34,11 @@ IndexBuffer::~IndexBuffer()
     driver->destroyIndexBuffer(m_handle);
 }
 
-bool IndexBuffer::init(IndexType indexType, uint32_t indexCount)
+bool IndexBuffer::init(IndexType indexType, uint32_t indexCount, BufferUsage usage)
 {
     m_indexType = indexType;
     m_indexCount = indexCount;
+    m_usage = usage;
     return true;
 }
 
@@ -44,7 +46,7 @@ void IndexBuffer::createBuffer()
 {
     Driver* driver = Engine::getInstance()->getDriver();
     m_handle = driver->createIndexBuffer(static_cast<ElementType>(m_indexType),
-                                         m_indexCount, backend::BufferUsage::STATIC);
+                                         m_indexCount, m_usage);
 }
 
 void IndexBuffer::setBufferData(const void* data, size_t size, size_t offset)
@@ -53,4 +55,10 @@ void IndexBuffer::setBufferData(const void* data, size_t size, size_t offset)
     driver->updateIndexBufferData(m_handle, data, size, offset);
 }
 
+size_t IndexBuffer::streamData(const void* data, size_t size)
+{
+    Driver* driver = Engine::getInstance()->getDriver();
+    return driver->streamIndexBufferData(m_handle, data, size);
+}
+
 } // namespace ocf
@@ -1,18 +1,17 @@
 #include "RenderQueue.h"
 
 #include "ocf/renderer/RenderCommand.h"
-#include <algorithm>
+#include <string.h>
+#include <utility>
 
 namespace ocf {
 
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+// Maps a float to an unsigned integer with the same order
+static uint32_t floatToSortable(float value)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
-}
-
-static bool compare3dCommnd(RenderCommand* a, RenderCommand* b)
-{
-    return a->getDepth() < b->getDepth();
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
 }
 
 RenderQueue::RenderQueue()
@@ -23,63 +22,119 @@ RenderQueue::~RenderQueue()
 {
 }
 
-void RenderQueue::emplace_back(RenderCommand* pCommand)
+uint64_t RenderQueue::makeSortKey(const RenderCommand* pCommand)
 {
+    // Bits below the group:
+    //   60..29  global Z order or depth
+    //   60..45  program, 44..29 texture, 28..0 depth (opaque 3D)
+    constexpr uint32_t ORDER_SHIFT = 29;
+
+    QueueGroup group;
+    uint64_t payload = 0;
+
     const float z = pCommand->getGlobalOrder();
     if (z < 0.0f) {
-        m_commands[QueueGroup::GLOBALZ_NEG].emplace_back(pCommand);
+        group = GLOBALZ_NEG;
+        payload = uint64_t(floatToSortable(z)) << ORDER_SHIFT;
     }
     else if (z > 0.0f) {
-        m_commands[QueueGroup::GLOBALZ_POS].emplace_back(pCommand);
+        group = GLOBALZ_POS;
+        payload = uint64_t(floatToSortable(z)) << ORDER_SHIFT;
     }
-    else {
-        if (pCommand->is3D()) {
-            if (pCommand->isTransparent()) {
-                m_commands[QueueGroup::TRANSPARENT_3D].emplace_back(pCommand);
-            }
-            else {
-                m_commands[QueueGroup::OPAQUE_3D].emplace_back(pCommand);
-            }
+    else if (pCommand->is3D()) {
+        const uint64_t depth = floatToSortable(pCommand->getDepth());
+        if (pCommand->isTransparent()) {
+            group = TRANSPARENT_3D;
+            payload = depth << ORDER_SHIFT;
         }
         else {
-            m_commands[QueueGroup::GLOBALZ_ZERO].emplace_back(pCommand);
+            const RenderCommand::PipelineState& pipeline = pCommand->getPipelineState();
+            const uint64_t program = pipeline.program.getId() & 0xFFFFu;
+            const uint64_t texture = pipeline.texture.getId() & 0xFFFFu;
+            payload = (program << 45) | (texture << ORDER_SHIFT) | (depth >> 3);
+            group = OPAQUE_3D;
         }
     }
+    else {
+        // 2D commands are drawn in the order they were added
+        group = GLOBALZ_ZERO;
+    }
+
+    return (uint64_t(group) << GROUP_SHIFT) | payload;
 }
 
-size_t RenderQueue::size() const
+void RenderQueue::emplace_back(RenderCommand* pCommand)
 {
-    size_t result = 0;
-    for (int i = 0; i < QueueGroup::QUEUE_COUNT; i++) {
-        result += m_commands[i].size();
-    }
-
-    return result;
+    m_entries.push_back({makeSortKey(pCommand), pCommand});
 }
 
 void RenderQueue::sort()
 {
-    std::stable_sort(std::begin(m_commands[QueueGroup::TRANSPARENT_3D]),
-                     std::end(m_commands[QueueGroup::TRANSPARENT_3D]), compare3dCommnd);
-    std::stable_sort(std::begin(m_commands[QueueGroup::GLOBALZ_NEG]),
-                     std::end(m_commands[QueueGroup::GLOBALZ_NEG]), compareRenderCommand);
-    std::stable_sort(std::begin(m_commands[QueueGroup::GLOBALZ_POS]),
-                     std::end(m_commands[QueueGroup::GLOBALZ_POS]), compareRenderCommand);
+    const size_t count = m_entries.size();
+
+    if (count > 1) {
+        // Histograms of every byte of the keys, computed in a single pass
+        constexpr size_t PASS_COUNT = sizeof(uint64_t);
+        size_t histograms[PASS_COUNT][256] = {};
+        for (const Entry& entry : m_entries) {
+            for (size_t pass = 0; pass < PASS_COUNT; pass++) {
+                histograms[pass][(entry.key >> (pass * 8)) & 0xFF]++;
+            }
+        }
+
+        m_sortBuffer.resize(count);
+        Entry* source = m_entries.data();
+        Entry* destination = m_sortBuffer.data();
+        for (size_t pass = 0; pass < PASS_COUNT; pass++) {
+            size_t* histogram = histograms[pass];
+            const uint32_t shift = static_cast<uint32_t>(pass * 8);
+
+            // Every key has the same byte, the pass wouldn't move anything
+            if (histogram[(source[0].key >> shift) & 0xFF] == count) {
+                continue;
+            }
+
+            size_t offset = 0;
+            for (size_t digit = 0; digit < 256; digit++) {
+                const size_t digitCount = histogram[digit];
+                histogram[digit] = offset;
+                offset += digitCount;
+            }
+            for (size_t i = 0; i < count; i++) {
+                const Entry& entry = source[i];
+                destination[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+            }
+            std::swap(source, destination);
+        }
+
+        if (source != m_entries.data()) {
+            m_entries.swap(m_sortBuffer);
+        }
+    }
+
+    size_t index = 0;
+    for (int group = 0; group < QueueGroup::QUEUE_COUNT; group++) {
+        m_groupBegin[group] = index;
+        while (index < count && getGroup(m_entries[index].key) == group) {
+            index++;
+        }
+    }
+    m_groupBegin[QueueGroup::QUEUE_COUNT] = count;
 }
 
 void RenderQueue::clear()
 {
-    for (int i = 0; i < QueueGroup::QUEUE_COUNT; i++) {
-        m_commands[i].clear();
+    m_entries.clear();
+    for (size_t& begin : m_groupBegin) {
+        begin = 0;
     }
 }
 
 void RenderQueue::realloc(size_t reserveSize)
 {
-    for (int i = 0; i < QueueGroup::QUEUE_COUNT; i++) {
-        m_commands[i].clear();
-        m_commands[i].reserve(reserveSize);
-    }
+    clear();
+    m_entries.reserve(reserveSize);
+    m_sortBuffer.reserve(reserveSize);
 }
 
 } // namespace ocf
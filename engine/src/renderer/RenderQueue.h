@@ -1,10 +1,25 @@
 #pragma once
+#include <stddef.h>
+#include <stdint.h>
 #include <vector>
 
 namespace ocf {
 
 class RenderCommand;
 
+/**
+ * @brief Commands of a frame, sorted into drawing order by 64-bit keys
+ *
+ * Every command is stored next to a sort key computed when it is added. The
+ * most significant bits hold the queue group, the rest depends on the group:
+ * - GLOBALZ_NEG, GLOBALZ_POS: global Z order
+ * - OPAQUE_3D: program, texture and depth, to minimize state changes
+ * - TRANSPARENT_3D: depth
+ * - GLOBALZ_ZERO: nothing, commands keep the order they were added in
+ *
+ * sort() is a stable LSD radix sort over the keys, so commands with equal
+ * keys keep their submission order.
+ */
 class RenderQueue {
 public:
     enum QueueGroup {
@@ -16,19 +31,55 @@ public:
         QUEUE_COUNT     = 5
     };
 
+    struct Entry {
+        uint64_t key;
+        RenderCommand* command;
+    };
+
     RenderQueue();
     ~RenderQueue();
 
     void emplace_back(RenderCommand* pCommand);
-    size_t size() const;
+    size_t size() const { return m_entries.size(); }
     void sort();
     void clear();
     void realloc(size_t reserveSize);
-    std::vector<RenderCommand*>& getSubQueue(QueueGroup group) { return m_commands[group]; }
-    size_t getSubQueueSize(QueueGroup group) const { return m_commands[group].size(); }
+
+    /**
+     * @brief Get the entries of a group, valid after sort()
+     *
+     * @param group Queue group
+     * @param outBegin Index of the first entry of the group
+     * @param outEnd Index past the last entry of the group
+     */
+    void getSubQueueRange(QueueGroup group, size_t& outBegin, size_t& outEnd) const
+    {
+        outBegin = m_groupBegin[group];
+        outEnd = m_groupBegin[group + 1];
+    }
+
+    size_t getSubQueueSize(QueueGroup group) const
+    {
+        return m_groupBegin[group + 1] - m_groupBegin[group];
+    }
+
+    RenderCommand* getCommand(size_t index) const { return m_entries[index].command; }
+
+    const std::vector<Entry>& getEntries() const { return m_entries; }
+
+    /**
+     * @brief Compute the sort key of a command
+     */
+    static uint64_t makeSortKey(const RenderCommand* pCommand);
+
+    static QueueGroup getGroup(uint64_t key) { return QueueGroup(key >> GROUP_SHIFT); }
 
 protected:
-    std::vector<RenderCommand*> m_commands[QUEUE_COUNT];
+    static constexpr uint32_t GROUP_SHIFT = 61;
+
+    std::vector<Entry> m_entries;
+    std::vector<Entry> m_sortBuffer;
+    size_t m_groupBegin[QUEUE_COUNT + 1] = {};
 };
 
 } // namespace ocf
@@ -1,12 +1,14 @@
 #include "ocf/renderer/Renderer.h"
 
 #include "RenderQueue.h"
+#include "VertexTransform.h"
 #include "backend/DriverBase.h"
 #include "backend/opengl/OpenGLInclude.h"
 #include "backend/opengl/OpenGLDriver.h"
 #include "platform/PlatformMacros.h"
 
 #include "ocf/core/FileUtils.h"
+#include "ocf/core/job/JobSystem.h"
 #include "ocf/base/Engine.h"
 #include "ocf/math/vec3.h"
 #include "ocf/renderer/Program.h"
@@ -17,15 +19,21 @@
 #include "ocf/renderer/backend/Driver.h"
 #include "ocf/renderer/TrianglesCommand.h"
 
+#include <algorithm>
+
 namespace ocf {
 
 using namespace math;
 using namespace backend;
 
+// Batches with fewer vertices are filled on the calling thread
+static constexpr unsigned int PARALLEL_FILL_MIN_VERTICES = 4096;
+
+// Number of commands filled by one job
+static constexpr uint32_t PARALLEL_FILL_GRAIN_SIZE = 64;
+
 Renderer::Renderer()
     : m_driver(nullptr)
-    , m_triangleVertices{}
-    , m_triangleIndices{}
 {
     m_renderGroups.emplace_back();
     m_triangleBatchToDraw = static_cast<TriangleBatchToDraw*>(
@@ -35,8 +43,10 @@ Renderer::Renderer()
 Renderer::~Renderer()
 {
     std::free(m_triangleBatchToDraw);
-    OCF_SAFE_DELETE(m_triangleVertexBuffer);
-    OCF_SAFE_DELETE(m_triangleIndexBuffer);
+    if (m_driver) {
+        destroyTriangleBuffers(m_triangleBuffers);
+        destroyTriangleBuffers(m_staticTriangleBuffers);
+    }
     OCF_SAFE_DELETE(m_driver);
 }
 
@@ -48,19 +58,7 @@ bool Renderer::init()
     OCF_LOG_INFO("Vender: {}", glDriver->getVenderString());
     OCF_LOG_INFO("Renderer: {}", glDriver->getRendererString());
 
-    m_triangleVertexBuffer = VertexBuffer::create(VBO_SIZE, sizeof(m_triangleVertices),
-                                                  VertexBuffer::BufferUsage::DYNAMIC);
-    m_triangleVertexBuffer->setAttribute(VertexAttribute::POSITION, VertexBuffer::AttributeType::FLOAT3, sizeof(Vertex3fC3fT2f), 0);
-    m_triangleVertexBuffer->setAttribute(VertexAttribute::COLOR, VertexBuffer::AttributeType::FLOAT3, sizeof(Vertex3fC3fT2f), sizeof(vec3));
-    m_triangleVertexBuffer->setAttribute(VertexAttribute::TEXCOORD0, VertexBuffer::AttributeType::FLOAT2, sizeof(Vertex3fC3fT2f), sizeof(vec3) * 2);
-    m_triangleVertexBuffer->createBuffer();
-
-    m_triangleIndexBuffer = IndexBuffer::create(IndexBuffer::IndexType::USHORT, INDEX_VBO_SIZE);
-    m_triangleIndexBuffer->createBuffer();
-
-    m_triangleRenderPrimitive = m_driver->createRenderPrimitive(m_triangleVertexBuffer->getHandle(),
-                                                                m_triangleIndexBuffer->getHandle(),
-                                                                PrimitiveType::TRIANGLES);
+    reserveTriangleBuffers(VBO_SIZE, INDEX_VBO_SIZE);
 
     m_trianglesCommands.reserve(64);
 
@@ -78,6 +76,8 @@ void Renderer::beginFrame()
 
 void Renderer::endFrame()
 {
+    m_driver->endFrame();
+
     m_drawCallCount = 0;
     m_drawVertexCount = 0;
 }
@@ -100,6 +100,22 @@ void Renderer::draw()
     for (auto&& renderQueue : m_renderGroups) {
         renderQueue.sort();
     }
+
+    // Every triangle batch of the frame is streamed into the same buffer segment,
+    // make room for all of them before the first flush
+    unsigned int frameVertexCount = 0;
+    unsigned int frameIndexCount = 0;
+    for (const RenderQueue& renderQueue : m_renderGroups) {
+        for (const RenderQueue::Entry& entry : renderQueue.getEntries()) {
+            if (entry.command->getType() == RenderCommand::Type::TrianglesCommand) {
+                const TrianglesCommand* cmd = static_cast<const TrianglesCommand*>(entry.command);
+                frameVertexCount += cmd->getVertexCount();
+                frameIndexCount += cmd->getIndexCount();
+            }
+        }
+    }
+    reserveTriangleBuffers(frameVertexCount, frameIndexCount);
+
     visitRenderQueue(m_renderGroups[0]);
 
     clean();
@@ -122,26 +138,20 @@ void Renderer::flush3D()
 
 void Renderer::visitRenderQueue(RenderQueue& queue)
 {
-    // Process Global-Z < 0 Objects
-    doVisitRenderQueue(queue.getSubQueue(RenderQueue::QueueGroup::GLOBALZ_NEG));
-
-    // Process Opaque 3D Objects
-    doVisitRenderQueue(queue.getSubQueue(RenderQueue::QueueGroup::OPAQUE_3D));
-
-    // Process 3D Transparent Objects
-    doVisitRenderQueue(queue.getSubQueue(RenderQueue::QueueGroup::TRANSPARENT_3D));
-    
-    // Process Global-Z = 0 Objects
-    doVisitRenderQueue(queue.getSubQueue(RenderQueue::QueueGroup::GLOBALZ_ZERO));
-
-    // Process Global-Z > 0 Objects
-    doVisitRenderQueue(queue.getSubQueue(RenderQueue::QueueGroup::GLOBALZ_POS));
+    // The queue is sorted by group: Global-Z < 0, opaque 3D, transparent 3D,
+    // Global-Z = 0 and Global-Z > 0 objects. Each group is flushed on its own.
+    for (int group = 0; group < RenderQueue::QueueGroup::QUEUE_COUNT; group++) {
+        size_t begin = 0;
+        size_t end = 0;
+        queue.getSubQueueRange(RenderQueue::QueueGroup(group), begin, end);
+        doVisitRenderQueue(queue, begin, end);
+    }
 }
 
-void Renderer::doVisitRenderQueue(const std::vector<RenderCommand*>& renderCommands)
+void Renderer::doVisitRenderQueue(const RenderQueue& queue, size_t begin, size_t end)
 {
-    for (const auto& command : renderCommands) {
-        processRenderCommand(command);
+    for (size_t i = begin; i < end; i++) {
+        processRenderCommand(queue.getCommand(i));
     }
     flush();
 }
@@ -155,13 +165,8 @@ void Renderer::processRenderCommand(RenderCommand* command)
     {
         flush3D();
 
+        // The triangle buffers grow to fit the batch, so it is only cut by other commands
         TrianglesCommand* cmd = static_cast<TrianglesCommand*>(command);
-
-        if ((m_triangleVertexCount + cmd->getVertexCount() > VBO_SIZE) ||
-            (m_triangleIndexCount + cmd->getIndexCount() > INDEX_VBO_SIZE)) {
-            drawTrianglesCommand();
-        }
-
         m_trianglesCommands.emplace_back(cmd);
     }
     break;
@@ -178,32 +183,53 @@ void Renderer::processRenderCommand(RenderCommand* command)
 }
 
 void Renderer::trianglesVerticesAndIndices(TrianglesCommand* command,
+                                           const TrianglesOffsets& offsets,
                                            unsigned int vertexBufferOffset)
 {
-    // Add vertices to array
-    unsigned int vertexCount = command->getTriangles().vertexCount;
-    memcpy(&m_triangleVertices[m_triangleVertexCount], command->getTriangles().vertices,
-           sizeof(Vertex3fC3fT2f) * vertexCount);
-
-    // local to world space
-    const mat4& modelView = command->getModelView();
-    for (unsigned int i = 0; i < vertexCount; i++) {
-        Vertex3fC3fT2f vertex = m_triangleVertices[m_triangleVertexCount + i];
-        m_triangleVertices[m_triangleVertexCount + i].position =
-            modelView * vec4(vertex.position, 1.0f);
+    // Add vertices to array, local to world space
+    const unsigned int vertexCount = command->getTriangles().vertexCount;
+    Vertex3fC3fT2f* vertices = &m_triangleVertices[offsets.vertex];
+    if (const Vertex3fC3fT2f* cached = command->getCachedWorldVertices()) {
+        memcpy(vertices, cached, sizeof(Vertex3fC3fT2f) * vertexCount);
+    }
+    else {
+        transformVertices(command->getModelView(), command->getTriangles().vertices, vertices,
+                          vertexCount);
+        if (command->isCachingWorldVertices()) {
+            command->cacheWorldVertices(vertices);
+        }
     }
 
     // Add indices to array
     const unsigned short* indices = command->getTriangles().indices;
     const unsigned int indexCount = command->getTriangles().indexCount;
-    const unsigned int offset = m_triangleVertexCount + vertexBufferOffset;
+    const unsigned int offset = offsets.vertex + vertexBufferOffset;
+    uint32_t* destination = &m_triangleIndices[offsets.index];
     for (unsigned int i = 0; i < indexCount; i++) {
-        m_triangleIndices[m_triangleIndexCount + i] =
-            static_cast<unsigned short>(offset + indices[i]);
+        destination[i] = offset + indices[i];
     }
+}
 
-    m_triangleVertexCount += vertexCount;
-    m_triangleIndexCount += indexCount;
+void Renderer::fillTrianglesVerticesAndIndices(unsigned int vertexBufferOffset)
+{
+    // Every command writes to its own range of the arrays, so commands can be filled in any order
+    const uint32_t commandCount = static_cast<uint32_t>(m_trianglesCommands.size());
+    auto fill = [this, vertexBufferOffset](uint32_t first, uint32_t last) {
+        for (uint32_t i = first; i < last; i++) {
+            trianglesVerticesAndIndices(m_trianglesCommands[i], m_trianglesOffsets[i],
+                                        vertexBufferOffset);
+        }
+    };
+
+    job::JobSystem& jobSystem = job::JobSystem::getInstance();
+    if (m_triangleVertexCount >= PARALLEL_FILL_MIN_VERTICES && jobSystem.isInitialized()
+        && jobSystem.getWorkerCount() > 0) {
+        jobSystem.parallelFor(0, commandCount, PARALLEL_FILL_GRAIN_SIZE, fill,
+                              job::JobPriority::High);
+    }
+    else {
+        fill(0, commandCount);
+    }
 }
 
 void Renderer::drawTrianglesCommand()
@@ -227,8 +253,15 @@ void Renderer::drawTrianglesCommand()
 
     uint32_t prevMaterialID = 0;
 
-    for (const auto& cmd : m_trianglesCommands) {
-        trianglesVerticesAndIndices(cmd, vertexBufferOffset);
+    /*
+     * Compute where each command goes in the arrays, and the batches
+     */
+    m_trianglesOffsets.resize(m_trianglesCommands.size());
+    for (size_t i = 0; i < m_trianglesCommands.size(); i++) {
+        TrianglesCommand* cmd = m_trianglesCommands[i];
+        m_trianglesOffsets[i] = {m_triangleVertexCount, m_triangleIndexCount};
+        m_triangleVertexCount += cmd->getVertexCount();
+        m_triangleIndexCount += cmd->getIndexCount();
 
         uint32_t currentMaterialID = cmd->getMaterialID();
 
@@ -260,10 +293,37 @@ void Renderer::drawTrianglesCommand()
     }
     batchTotal++;
 
-    m_triangleVertexBuffer->setBufferData(m_triangleVertices,
-                                          sizeof(m_triangleVertices[0]) * m_triangleVertexCount, 0);
-    m_triangleIndexBuffer->setBufferData(m_triangleIndices,
-                                         sizeof(m_triangleIndices[0]) * m_triangleIndexCount, 0);
+    backend::RenderPrimitiveHandle renderPrimitive = m_triangleBuffers.renderPrimitive;
+    size_t indexDataOffset = 0;
+    int32_t baseVertex = 0;
+
+    if (m_staticBatching && isStagedTrianglesBatch()) {
+        // The staging arrays still hold this batch, keep it in the retained buffers
+        if (!m_staticBatchUploaded) {
+            uploadStaticTrianglesBatch();
+        }
+        renderPrimitive = m_staticTriangleBuffers.renderPrimitive;
+    }
+    else {
+        fillTrianglesVerticesAndIndices(vertexBufferOffset);
+
+        if (m_staticBatching) {
+            m_stagedTrianglesCommands = m_trianglesCommands;
+            m_staticBatchUploaded = false;
+        }
+
+        // Append the batch to the stream buffers, the indices are relative to its first vertex
+        const size_t vertexDataOffset = m_triangleBuffers.vertexBuffer->streamData(
+            m_triangleVertices.data(), sizeof(m_triangleVertices[0]) * m_triangleVertexCount,
+            sizeof(m_triangleVertices[0]));
+        indexDataOffset = m_triangleBuffers.indexBuffer->streamData(
+            m_triangleIndices.data(), sizeof(m_triangleIndices[0]) * m_triangleIndexCount);
+        if (vertexDataOffset == SIZE_MAX || indexDataOffset == SIZE_MAX) {
+            m_trianglesCommands.clear();
+            return;
+        }
+        baseVertex = static_cast<int32_t>(vertexDataOffset / sizeof(m_triangleVertices[0]));
+    }
 
     /*
      * Draw all batches
@@ -271,10 +331,11 @@ void Renderer::drawTrianglesCommand()
     for (int i = 0; i < batchTotal; i++) {
         auto& drawInfo = m_triangleBatchToDraw[i];
 
-        const uint32_t offset = drawInfo.offset * sizeof(m_triangleIndices[0]);
+        const uint32_t offset =
+            static_cast<uint32_t>(indexDataOffset + drawInfo.offset * sizeof(m_triangleIndices[0]));
 
-        m_driver->draw(drawInfo.command->getPipelineState(), m_triangleRenderPrimitive, offset,
-                       drawInfo.indicesToDraw);
+        m_driver->draw(drawInfo.command->getPipelineState(), renderPrimitive, offset,
+                       drawInfo.indicesToDraw, baseVertex);
 
         m_drawCallCount++;
         m_drawVertexCount += drawInfo.indicesToDraw;
@@ -286,9 +347,109 @@ void Renderer::drawTrianglesCommand()
     m_trianglesCommands.clear();
 }
 
+void Renderer::reserveTriangleBuffers(unsigned int vertexCount, unsigned int indexCount)
+{
+    if (vertexCount <= m_triangleBuffers.vertexCapacity
+        && indexCount <= m_triangleBuffers.indexCapacity) {
+        return;
+    }
+
+    // Double the capacity, so a growing scene reallocates the GPU buffers only a few times
+    unsigned int vertexCapacity = std::max(m_triangleBuffers.vertexCapacity, 1u);
+    while (vertexCapacity < vertexCount) {
+        vertexCapacity *= 2;
+    }
+    unsigned int indexCapacity = std::max(m_triangleBuffers.indexCapacity, 1u);
+    while (indexCapacity < indexCount) {
+        indexCapacity *= 2;
+    }
+
+    OCF_LOG_DEBUG("Growing the triangle buffers to {} vertices and {} indices", vertexCapacity,
+                  indexCapacity);
+    destroyTriangleBuffers(m_triangleBuffers);
+    createTriangleBuffers(m_triangleBuffers, vertexCapacity, indexCapacity,
+                          BufferUsage::STREAM);
+
+    // The staging arrays match the buffers, on the heap rather than in the renderer
+    m_triangleVertices.resize(vertexCapacity);
+    m_triangleIndices.resize(indexCapacity);
+
+    m_stagedTrianglesCommands.clear();
+}
+
+void Renderer::createTriangleBuffers(TriangleBuffers& buffers, unsigned int vertexCapacity,
+                                     unsigned int indexCapacity, BufferUsage usage)
+{
+    buffers.vertexBuffer = VertexBuffer::create(vertexCapacity,
+                                                sizeof(Vertex3fC3fT2f) * vertexCapacity, usage);
+    buffers.vertexBuffer->setAttribute(VertexAttribute::POSITION, VertexBuffer::AttributeType::FLOAT3, sizeof(Vertex3fC3fT2f), 0);
+    buffers.vertexBuffer->setAttribute(VertexAttribute::COLOR, VertexBuffer::AttributeType::FLOAT3, sizeof(Vertex3fC3fT2f), sizeof(vec3));
+    buffers.vertexBuffer->setAttribute(VertexAttribute::TEXCOORD0, VertexBuffer::AttributeType::FLOAT2, sizeof(Vertex3fC3fT2f), sizeof(vec3) * 2);
+    buffers.vertexBuffer->createBuffer();
+
+    buffers.indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::UINT, indexCapacity, usage);
+    buffers.indexBuffer->createBuffer();
+
+    buffers.renderPrimitive = m_driver->createRenderPrimitive(buffers.vertexBuffer->getHandle(),
+                                                              buffers.indexBuffer->getHandle(),
+                                                              PrimitiveType::TRIANGLES);
+
+    buffers.vertexCapacity = vertexCapacity;
+    buffers.indexCapacity = indexCapacity;
+}
+
+void Renderer::destroyTriangleBuffers(TriangleBuffers& buffers)
+{
+    m_driver->destroyRenderPrimitive(buffers.renderPrimitive);
+    buffers.renderPrimitive.clear();
+    OCF_SAFE_DELETE(buffers.vertexBuffer);
+    OCF_SAFE_DELETE(buffers.indexBuffer);
+    buffers.vertexCapacity = 0;
+    buffers.indexCapacity = 0;
+}
+
+void Renderer::uploadStaticTrianglesBatch()
+{
+    TriangleBuffers& buffers = m_staticTriangleBuffers;
+    if (m_triangleVertexCount > buffers.vertexCapacity
+        || m_triangleIndexCount > buffers.indexCapacity) {
+        destroyTriangleBuffers(buffers);
+        createTriangleBuffers(buffers, m_triangleVertexCount, m_triangleIndexCount,
+                              BufferUsage::DYNAMIC);
+    }
+
+    buffers.vertexBuffer->setBufferData(m_triangleVertices.data(),
+                                        sizeof(m_triangleVertices[0]) * m_triangleVertexCount, 0);
+    buffers.indexBuffer->setBufferData(m_triangleIndices.data(),
+                                       sizeof(m_triangleIndices[0]) * m_triangleIndexCount, 0);
+    m_staticBatchUploaded = true;
+}
+
+void Renderer::setStaticBatching(bool enabled)
+{
+    m_staticBatching = enabled;
+    m_stagedTrianglesCommands.clear();
+    m_staticBatchUploaded = false;
+    if (!enabled && m_driver) {
+        destroyTriangleBuffers(m_staticTriangleBuffers);
+    }
+}
+
+bool Renderer::isStagedTrianglesBatch() const
+{
+    if (m_stagedTrianglesCommands != m_trianglesCommands) {
+        return false;
+    }
+    return std::all_of(m_trianglesCommands.begin(), m_trianglesCommands.end(),
+                       [](const TrianglesCommand* command) {
+                           return command->isTransformUnchanged();
+                       });
+}
+
 void Renderer::drawMeshCommand(RenderCommand* command)
 {
-    m_driver->draw(command->getPipelineState(), command->getHandle(), 0, command->getIndexCount());
+    m_driver->draw(command->getPipelineState(), command->getHandle(), 0, command->getIndexCount(),
+                   0);
 
     m_drawVertexCount += command->getIndexCount();
     m_drawCallCount++;
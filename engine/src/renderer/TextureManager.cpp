@@ -54,6 +54,7 @@ Texture* TextureManager::addImage(std::string_view filePath)
                                       Texture::InternalFormat::RGBA8);
             texture->setImage(0, std::move(buffer));
 
+            texture->retain();
             m_textures.emplace(fullPath, texture);
         }
         else {
@@ -101,6 +102,7 @@ Texture* TextureManager::getWhiteTexture(std::string_view key, uint8_t luma)
                                           Texture::Type::UNSIGNED_BYTE, nullptr);
     texture = Texture::create(Texture::Sampler::SAMPLER_2D, 2, 2, 1,
                               Texture::InternalFormat::RGBA8);
+    texture->retain();
     m_textures.emplace(key, texture);
 
     return texture;
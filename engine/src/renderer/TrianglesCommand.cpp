@@ -3,6 +3,8 @@
 #define XXH_INLINE_ALL
 #include "xxhash.h"
 
+#include <string.h>
+
 namespace ocf {
 
 TrianglesCommand::TrianglesCommand()
@@ -20,7 +22,13 @@ void TrianglesCommand::init(float globalZOrder, Texture* texture, const BlendFun
                             const Triangles& triangles, const math::mat4& modelView)
 {
     RenderCommand::init(globalZOrder, modelView);
+
+    if (m_triangles.vertices != triangles.vertices ||
+        m_triangles.vertexCount != triangles.vertexCount) {
+        m_worldVerticesValid = false;
+    }
     m_triangles = triangles;
+    m_transformUnchanged = false;
 
     if (m_texture != texture || m_blendFunc != blendFunc) {
         m_blendFunc = blendFunc;
@@ -32,6 +40,23 @@ void TrianglesCommand::init(float globalZOrder, Texture* texture, const BlendFun
     }
 }
 
+void TrianglesCommand::setCachingWorldVertices(bool caching)
+{
+    m_cachingWorldVertices = caching;
+    if (!caching) {
+        m_worldVertices.clear();
+        m_worldVertices.shrink_to_fit();
+        m_worldVerticesValid = false;
+    }
+}
+
+void TrianglesCommand::cacheWorldVertices(const Vertex3fC3fT2f* vertices)
+{
+    m_worldVertices.resize(m_triangles.vertexCount);
+    memcpy(m_worldVertices.data(), vertices, sizeof(Vertex3fC3fT2f) * m_triangles.vertexCount);
+    m_worldVerticesValid = true;
+}
+
 void TrianglesCommand::generateMaterialID()
 {
     struct {
@@ -46,6 +46,12 @@ void VertexBuffer::createBuffer()
     m_handle = driver->createVertexBuffer(m_vertexCount, m_byteCount, m_usage, m_vertexBufferInfoHandle);
 }
 
+size_t VertexBuffer::streamData(const void* data, size_t size, size_t alignment)
+{
+    Driver* driver = Engine::getInstance()->getDriver();
+    return driver->streamBufferData(m_handle, data, size, alignment);
+}
+
 void VertexBuffer::setAttribute(VertexAttribute attribute, AttributeType type,
                                 uint8_t stride, uint32_t offset)
 {
@@ -0,0 +1,49 @@
+#include "VertexTransform.h"
+
+#include "ocf/math/vec4.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCF_RENDERER_SSE2 1
+#endif
+
+namespace ocf {
+
+using namespace math;
+
+void transformVertices(const mat4& matrix, const Vertex3fC3fT2f* src, Vertex3fC3fT2f* dst,
+                       unsigned int count)
+{
+#if defined(OCF_RENDERER_SSE2)
+    const __m128 c0 = _mm_loadu_ps(&matrix[0].x);
+    const __m128 c1 = _mm_loadu_ps(&matrix[1].x);
+    const __m128 c2 = _mm_loadu_ps(&matrix[2].x);
+    const __m128 c3 = _mm_loadu_ps(&matrix[3].x);
+
+    for (unsigned int i = 0; i < count; i++) {
+        const vec3& p = src[i].position;
+        __m128 r = _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(p.x)), c3);
+        r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(p.y)));
+        r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(p.z)));
+
+        // Copy the whole vertex, then overwrite the position with x, y and z of the result
+        dst[i] = src[i];
+        float* position = &dst[i].position.x;
+        _mm_storel_pi(reinterpret_cast<__m64*>(position), r);
+        _mm_store_ss(position + 2, _mm_movehl_ps(r, r));
+    }
+#else
+    transformVerticesScalar(matrix, src, dst, count);
+#endif
+}
+
+void transformVerticesScalar(const mat4& matrix, const Vertex3fC3fT2f* src, Vertex3fC3fT2f* dst,
+                             unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i++) {
+        dst[i] = src[i];
+        dst[i].position = matrix * vec4(src[i].position, 1.0f);
+    }
+}
+
+} // namespace ocf
@@ -0,0 +1,21 @@
+#pragma once
+#include "ocf/base/Types.h"
+#include "ocf/math/mat4.h"
+
+namespace ocf {
+
+/**
+ * @brief Copy vertices and transform their positions (w = 1) by a matrix
+ *
+ * Uses SSE2 where available, otherwise transformVerticesScalar().
+ */
+void transformVertices(const math::mat4& matrix, const Vertex3fC3fT2f* src, Vertex3fC3fT2f* dst,
+                       unsigned int count);
+
+/**
+ * @brief Portable version of transformVertices(), one mat4 * vec4 per vertex
+ */
+void transformVerticesScalar(const math::mat4& matrix, const Vertex3fC3fT2f* src,
+                             Vertex3fC3fT2f* dst, unsigned int count);
+
+} // namespace ocf
@@ -1,4 +1,7 @@
 #include "renderer/backend/HandleAllocator.h"
+
+#include "platform/PlatformMacros.h"
+
 #include <stdlib.h>
 #include <string.h>
 
@@ -6,71 +9,85 @@ namespace ocf::backend {
 
 template <size_t P0, size_t P1, size_t P2>
 HandleAllocator<P0, P1, P2>::HandleAllocator(const char* name, size_t size)
-    : m_allocator(name, size)
+    : m_name(name)
+    , m_chunkSize(size)
 {
+    // Bits needed to address every slot of a chunk, the rest numbers the chunks
+    const size_t slotCount = (size + Allocator::getAliment() - 1) / Allocator::getAliment();
+    while ((size_t(1) << m_offsetBits) < slotCount) {
+        m_offsetBits++;
+    }
+    assert(m_offsetBits < HANDLE_INDEX_BIT_COUNT);
+    m_offsetMask = (1u << m_offsetBits) - 1u;
+    m_maxChunks = 1u << (HANDLE_INDEX_BIT_COUNT - m_offsetBits);
+
+    m_chunks = std::make_unique<std::unique_ptr<HandleLinerAllocator>[]>(m_maxChunks);
+    m_chunkBases = std::make_unique<char*[]>(m_maxChunks);
+    grow(0);
 }
 
 template <size_t P0, size_t P1, size_t P2>
-HandleAllocator<P0, P1, P2>::~HandleAllocator()
-{
-    for (auto& entry : m_handleMap) {
-        ::free(entry.second);
-    }
-}
+HandleAllocator<P0, P1, P2>::~HandleAllocator() = default;
 
 template <size_t P0, size_t P1, size_t P2>
-HandleBase::HandleId HandleAllocator<P0, P1, P2>::allocateHandleMap(size_t size)
+uint32_t HandleAllocator<P0, P1, P2>::grow(uint32_t knownCount)
 {
-    void* p = ::malloc(size);
+    std::lock_guard<std::mutex> lock(m_growLock);
 
-    HandleBase::HandleId id = ++m_id;
+    const uint32_t chunk = m_chunkCount.load(std::memory_order_relaxed);
+    if (chunk != knownCount) {
+        // Another thread has grown the arena meanwhile
+        return chunk;
+    }
+    if (chunk >= m_maxChunks) {
+        OCF_LOG_FATAL("{}: out of handle memory ({} chunks of {} bytes)", m_name, m_maxChunks,
+                      m_chunkSize);
+        abort();
+    }
 
-    m_handleMap.emplace(id, p);
+    if (chunk > 0) {
+        OCF_LOG_DEBUG("{}: growing the handle arena to {} bytes", m_name,
+                      (chunk + 1) * m_chunkSize);
+    }
 
-    return id;
+    m_chunks[chunk] = std::make_unique<HandleLinerAllocator>(m_name, m_chunkSize);
+    m_chunkBases[chunk] = static_cast<char*>(m_chunks[chunk]->getArea().begin());
+    m_chunkCount.store(chunk + 1, std::memory_order_release);
+    return chunk + 1;
 }
 
 template <size_t P0, size_t P1, size_t P2>
-void HandleAllocator<P0, P1, P2>::deallocateHandleMap(HandleBase::HandleId id, size_t) noexcept
+void HandleAllocator<P0, P1, P2>::reportStaleHandle(HandleBase::HandleId id,
+                                                    const char* typeName) const noexcept
 {
-    void* p = nullptr;
-
-    const auto& iter = m_handleMap.find(id);
-    if (iter != m_handleMap.end()) {
-        p = iter->second;
-        m_handleMap.erase(iter);
+    auto [p, tag] = handleToPointer(id);
+    if (p == nullptr) {
+        OCF_LOG_FATAL("{}: invalid handle {:#010x} of type {}, unknown chunk {}", m_name, id,
+                      typeName, getChunk(id));
     }
-
-    ::free(p);
+    else {
+        OCF_LOG_FATAL("{}: stale handle {:#010x} of type {}, handle age {} but slot age {}",
+                      m_name, id, typeName, tag >> HANDLE_AGE_SHIFT, getSlotAge(p));
+    }
+    abort();
 }
 
 template <size_t P0, size_t P1, size_t P2>
-void* HandleAllocator<P0, P1, P2>::handleToPointerHandleMap(HandleBase::HandleId id) const noexcept
+HandleAllocator<P0, P1, P2>::Allocator::Allocator(const AreaPolicy::HeapArea& area)
+    : m_pool0(clearArea(area), getPoolSize(area, P0))
+    , m_pool1(static_cast<char*>(area.begin()) + getPoolSize(area, P0), getPoolSize(area, P1))
+    , m_pool2(static_cast<char*>(area.begin()) + getPoolSize(area, P0) + getPoolSize(area, P1),
+              getPoolSize(area, P2))
+    , m_area(area)
 {
-    const auto& iter = m_handleMap.find(id);
-    if (iter != m_handleMap.end()) {
-        return iter->second;
-    }
-
-    return nullptr;
 }
 
 template <size_t P0, size_t P1, size_t P2>
-HandleAllocator<P0, P1, P2>::Allocator::Allocator(const AreaPolicy::HeapArea& area)
-    : m_area(area)
+char* HandleAllocator<P0, P1, P2>::Allocator::clearArea(const AreaPolicy::HeapArea& area) noexcept
 {
-    const size_t heapSizeMax = area.size();
-
-    memset(area.data(), 0, heapSizeMax);
-
-    const size_t count = heapSizeMax / (P0 + P1 + P2);
-    char* p0 = static_cast<char*>(area.begin());
-    char* p1 = p0 + count * P0;
-    char* p2 = p1 + count * P1;
-
-    m_pool0 = Pool<P0>(p0, count * P0);
-    m_pool1 = Pool<P1>(p1, count * P1);
-    m_pool2 = Pool<P2>(p2, count * P2);
+    // Every slot starts with age 0, must happen before the pools link their blocks
+    memset(area.data(), 0, area.size());
+    return static_cast<char*>(area.begin());
 }
 
 template class HandleAllocator<32, 96, 184>;
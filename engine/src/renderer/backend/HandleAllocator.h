@@ -1,10 +1,35 @@
 #pragma once
 #include "ocf/renderer/backend/Handle.h"
 #include "ocf/core/Allocator.h"
-#include <unordered_map>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <typeinfo>
+
+// Check the age of every handle passed to handle_cast() and deallocate(), so that
+// a handle used after its object was destroyed is reported instead of aliasing the
+// slot's new object. Enabled in debug builds unless defined otherwise.
+#if !defined(OCF_HANDLE_VALIDATION)
+#if defined(NDEBUG)
+#define OCF_HANDLE_VALIDATION 0
+#else
+#define OCF_HANDLE_VALIDATION 1
+#endif
+#endif
 
 namespace ocf::backend {
 
+/**
+ * @brief Allocates driver objects and hands out handles to them
+ *
+ * Handles can be allocated and freed from several threads at once, e.g. to
+ * reserve handles on worker threads while the objects are constructed later
+ * on the render thread. Each thread frees to and allocates from a small cache
+ * of its own, backed by lock-free pools. Only growing the arena takes a lock.
+ *
+ * Accessing the object of a handle is not synchronized, the caller has to
+ * make sure it is not freed meanwhile.
+ */
 template <size_t P0, size_t P1, size_t P2>
 class HandleAllocator {
 public:
@@ -42,6 +67,9 @@ public:
     void deallocate(Handle<B>& handle, D const* p) noexcept
     {
         if (p) {
+#if OCF_HANDLE_VALIDATION
+            validateHandle<D>(handle.getId());
+#endif
             p->~D();
             deallocateHandle<D>(handle.getId());
         }
@@ -53,11 +81,34 @@ public:
         std::is_base_of_v<B, std::remove_pointer_t<Dp>>, Dp>
     handle_cast(Handle<B>& handle) const noexcept
     {
+#if OCF_HANDLE_VALIDATION
+        validateHandle<std::remove_pointer_t<Dp>>(handle.getId());
+#endif
         auto [p, tag] = handleToPointer(handle.getId());
 
        return static_cast<Dp>(p);
     }
 
+    /**
+     * @brief Check if a handle still refers to a live object
+     *
+     * The age stored in a handle is compared with the age of its slot, which
+     * changes every time the slot is freed. Ages have 4 bits, so a handle
+     * whose slot has been reused a multiple of 16 times is not detected.
+     *
+     * @param id Id of the handle
+     * @return true if the handle was not freed, or is null
+     */
+    bool isValid(HandleBase::HandleId id) const noexcept
+    {
+        // Null handles are cast to nullptr, there is no slot to check
+        if (id == HandleBase::nullid) {
+            return true;
+        }
+        auto [p, tag] = handleToPointer(id);
+        return p != nullptr && getSlotAge(p) == (tag >> HANDLE_AGE_SHIFT);
+    }
+
     template <typename Dp, typename B>
     inline std::enable_if_t<
         std::is_pointer_v<Dp> &&
@@ -83,13 +134,21 @@ private:
         struct Node {
             uint8_t age;
         };
+        // Few blocks per thread, there is a set of caches per chunk
+        static constexpr size_t CACHE_SIZE = 16;
         template <size_t SIZE>
-        using Pool = MemoryPool<SIZE, MIN_ALIGNMENT, sizeof(Node)>;
+        using Pool = ThreadCachedMemoryPool<SIZE, MIN_ALIGNMENT, sizeof(Node), CACHE_SIZE>;
         Pool<P0> m_pool0;
         Pool<P1> m_pool1;
         Pool<P2> m_pool2;
         const AreaPolicy::HeapArea& m_area;
 
+        static char* clearArea(const AreaPolicy::HeapArea& area) noexcept;
+        static size_t getPoolSize(const AreaPolicy::HeapArea& area, size_t elementSize) noexcept
+        {
+            return area.size() / (P0 + P1 + P2) * elementSize;
+        }
+
     public:
         explicit Allocator(const AreaPolicy::HeapArea& area);
 
@@ -112,6 +171,7 @@ private:
         void free(void* p, size_t size, uint8_t) noexcept
         {
             Node* const pNode = static_cast<Node*>(p);
+            // The pool publishes the new age to the thread allocating the block next
             uint8_t& expectedAge = pNode[-1].age;
             expectedAge = (expectedAge + 1) & 0xF; // fixme
 
@@ -137,53 +197,96 @@ private:
         deallocateHandleInPool<BUCKET_SIZE>(id);
     }
 
+    template <size_t SIZE> static constexpr size_t getBucketIndex() noexcept
+    {
+        static_assert(SIZE == P0 || SIZE == P1 || SIZE == P2, "SIZE isn't a bucket size");
+        return SIZE == P0 ? 0 : SIZE == P1 ? 1 : 2;
+    }
+
     template <size_t SIZE>
     HandleBase::HandleId allocateHandleInPool() noexcept
     {
-        uint8_t age;
-        void* p = m_allocator.alloc(SIZE, alignof(std::max_align_t), 0, &age);
-        if (p != nullptr) {
-            return linearPoolPointerToHandle(p, age);
+        std::atomic<uint32_t>& hint = m_allocHints[getBucketIndex<SIZE>()];
+        uint8_t age = 0;
+        uint32_t first = hint.load(std::memory_order_relaxed);
+        const uint32_t start = first;
+        uint32_t count = m_chunkCount.load(std::memory_order_acquire);
+        for (;;) {
+            // Chunks below the hint have no free slot of this size
+            for (uint32_t chunk = first; chunk < count; ++chunk) {
+                void* p = m_chunks[chunk]->alloc(SIZE, alignof(std::max_align_t), 0, &age);
+                if (p != nullptr) {
+                    if (chunk != start) {
+                        // Unless a free has moved the hint meanwhile
+                        uint32_t expected = start;
+                        hint.compare_exchange_strong(expected, chunk, std::memory_order_relaxed);
+                    }
+                    return pointerToHandle(chunk, p, age);
+                }
+            }
+            first = count;
+            count = grow(count);
         }
-
-        return allocateHandleMap(SIZE);
     }
 
     template <size_t SIZE>
     void deallocateHandleInPool(HandleBase::HandleId id) noexcept
     {
-        if (isPoolHandle(id)) {
-            auto [p, tag] = handleToPointer(id);
-            uint8_t age = (tag & HANDLE_AGE_MASK) >> HANDLE_AGE_SHIFT;
-            m_allocator.free(p, SIZE, age);
-        } else {
-            deallocateHandleMap(id, SIZE);
+        auto [p, tag] = handleToPointer(id);
+        uint8_t age = (tag & HANDLE_AGE_MASK) >> HANDLE_AGE_SHIFT;
+        const uint32_t chunk = getChunk(id);
+        m_chunks[chunk]->free(p, SIZE, age);
+
+        // The chunk has a free slot again, the next allocation starts there
+        std::atomic<uint32_t>& hint = m_allocHints[getBucketIndex<SIZE>()];
+        uint32_t current = hint.load(std::memory_order_relaxed);
+        while (chunk < current
+               && !hint.compare_exchange_weak(current, chunk, std::memory_order_relaxed)) {
         }
     }
 
     std::pair<void*, uint32_t> handleToPointer(HandleBase::HandleId id) const noexcept
     {
-        if (isPoolHandle(id)) {
-            char* base = static_cast<char*>(m_allocator.getArea().begin());
-            size_t offset = (id & HANDLE_INDEX_MASK) * Allocator::getAliment();
-            return { static_cast<void*>(base + offset), 0 };
+        // Null handles and handles of chunks that were never allocated have no object
+        if (id == HandleBase::nullid
+            || getChunk(id) >= m_chunkCount.load(std::memory_order_acquire)) {
+            return {nullptr, 0};
         }
-        return { handleToPointerHandleMap(id), 0 };
+        size_t offset = (id & m_offsetMask) * Allocator::getAliment();
+        return { static_cast<void*>(m_chunkBases[getChunk(id)] + offset), id & HANDLE_AGE_MASK };
     }
 
-    HandleBase::HandleId linearPoolPointerToHandle(void* p, uint32_t tag) const noexcept
+    HandleBase::HandleId pointerToHandle(uint32_t chunk, void* p, uint8_t age) const noexcept
     {
-        char* base = static_cast<char*>(m_allocator.getArea().begin());
-        size_t offset = static_cast<char*>(p) - base;
+        size_t offset = static_cast<char*>(p) - m_chunkBases[chunk];
         auto id = static_cast<HandleBase::HandleId>(offset / Allocator::getAliment());
-        id |= tag & HANDLE_AGE_MASK;
+        id |= chunk << m_offsetBits;
+        id |= (uint32_t(age) << HANDLE_AGE_SHIFT) & HANDLE_AGE_MASK;
         return id;
     }
 
-    HandleBase::HandleId allocateHandleMap(size_t size);
-    void deallocateHandleMap(HandleBase::HandleId id, size_t size) noexcept;
+    static uint8_t getSlotAge(const void* p) noexcept
+    {
+        return static_cast<const typename Allocator::Node*>(p)[-1].age;
+    }
+
+    template <typename D>
+    void validateHandle(HandleBase::HandleId id) const noexcept
+    {
+        if (!isValid(id)) {
+            reportStaleHandle(id, typeid(D).name());
+        }
+    }
 
-    void* handleToPointerHandleMap(HandleBase::HandleId id) const noexcept;
+    [[noreturn]] void reportStaleHandle(HandleBase::HandleId id, const char* typeName) const noexcept;
+
+    uint32_t getChunk(HandleBase::HandleId id) const noexcept
+    {
+        return (id & HANDLE_INDEX_MASK) >> m_offsetBits;
+    }
+
+    // Adds a chunk unless another thread did since knownCount was read, returns the new count
+    uint32_t grow(uint32_t knownCount);
 
     static constexpr uint32_t HANDLE_AGE_BIT_COUNT = 4u;
 
@@ -192,19 +295,26 @@ private:
     static constexpr uint32_t HANDLE_AGE_MASK = ((1u << HANDLE_AGE_BIT_COUNT) - 1u)
                                                 << HANDLE_AGE_SHIFT;
 
-    static constexpr uint32_t HANDLE_INDEX_MASK = 0x07FFFFFFu;
+    // Chunk index in the high bits, offset in the chunk in the low bits
+    static constexpr uint32_t HANDLE_INDEX_BIT_COUNT = 27u;
 
-    static constexpr uint32_t HANDLE_HEAP_FLAG = 0x80000000u;
-
-    static bool isPoolHandle(HandleBase::HandleId id) noexcept
-    {
-        return (id & HANDLE_HEAP_FLAG) == 0u;
-    }
+    static constexpr uint32_t HANDLE_INDEX_MASK = (1u << HANDLE_INDEX_BIT_COUNT) - 1u;
 
 private:
-    HandleLinerAllocator m_allocator;
-    std::unordered_map<HandleBase::HandleId, void*> m_handleMap;
-    HandleBase::HandleId m_id = 0;
+    const char* m_name;
+    size_t m_chunkSize;
+    uint32_t m_offsetBits = 0;
+    uint32_t m_offsetMask = 0;
+    uint32_t m_maxChunks = 0;
+    // The arena grows in chunks of m_chunkSize bytes, existing chunks never move.
+    // Both arrays hold m_maxChunks entries, so chunks are added without reallocating
+    // them and published to other threads by m_chunkCount.
+    std::unique_ptr<std::unique_ptr<HandleLinerAllocator>[]> m_chunks;
+    std::unique_ptr<char*[]> m_chunkBases;
+    std::atomic<uint32_t> m_chunkCount{0};
+    std::mutex m_growLock;
+    // Per bucket size, first chunk that may have a free slot
+    std::atomic<uint32_t> m_allocHints[3] = {};
 };
 
 using HandleAllocatorGL = HandleAllocator<32, 96, 184>;
@@ -1,5 +1,7 @@
 #include "OpenGLDriver.h"
 #include "OpenGLUtility.h"
+#include <algorithm>
+#include <assert.h>
 #include <limits>
 #include <iostream>
 
@@ -51,9 +53,16 @@ VertexBufferHandle OpenGLDriver::createVertexBuffer(uint32_t vertexCount, uint32
     const uint32_t version = vb->bufferObjectVertion;
     vb->bufferObjectVertion = (version + 1) % kMaxVersion;
 
-    glGenBuffers(1, &vb->gl.id);
-    gl.bindBuffer(GL_ARRAY_BUFFER, vb->gl.id);
-    glBufferData(GL_ARRAY_BUFFER, byteCount, nullptr, OpenGLUtility::getBufferUsage(usage));
+    if (usage == BufferUsage::STREAM) {
+        vb->stream = std::make_unique<OpenGLStreamBuffer>(gl, GL_ARRAY_BUFFER, byteCount);
+        vb->gl.id = vb->stream->getId();
+        m_streamBuffers.push_back(vb->stream.get());
+    }
+    else {
+        glGenBuffers(1, &vb->gl.id);
+        gl.bindBuffer(GL_ARRAY_BUFFER, vb->gl.id);
+        glBufferData(GL_ARRAY_BUFFER, byteCount, nullptr, OpenGLUtility::getBufferUsage(usage));
+    }
 
     CHECK_GL_ERROR(std::cerr);
 
@@ -71,9 +80,18 @@ IndexBufferHandle OpenGLDriver::createIndexBuffer(ElementType elementType, uint3
     
     GLIndexBuffer* ib = construct<GLIndexBuffer>(handle, elementSize, indexCount, usage);
 
-    glGenBuffers(1, &ib->gl.id);
-    gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ib->gl.id);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, nullptr, OpenGLUtility::getBufferUsage(usage));
+    if (usage == BufferUsage::STREAM) {
+        ib->stream = std::make_unique<OpenGLStreamBuffer>(gl, GL_ELEMENT_ARRAY_BUFFER, size);
+        ib->gl.id = ib->stream->getId();
+        m_streamBuffers.push_back(ib->stream.get());
+    }
+    else {
+        // Don't change the element array buffer of the bound vertex array
+        gl.bindVertexArray(nullptr);
+        glGenBuffers(1, &ib->gl.id);
+        gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ib->gl.id);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, nullptr, OpenGLUtility::getBufferUsage(usage));
+    }
 
     CHECK_GL_ERROR(std::cerr);
 
@@ -162,7 +180,14 @@ void OpenGLDriver::destroyVertexBuffer(VertexBufferHandle handle)
 {
     if (handle) {
         GLVertexBuffer* vb = handle_cast<GLVertexBuffer*>(handle);
-        glDeleteBuffers(1, &vb->gl.id);
+        if (vb->stream) {
+            m_streamBuffers.erase(
+                std::remove(m_streamBuffers.begin(), m_streamBuffers.end(), vb->stream.get()),
+                m_streamBuffers.end());
+        }
+        else {
+            glDeleteBuffers(1, &vb->gl.id);
+        }
         destruct(handle, vb);
     }
 }
@@ -172,7 +197,14 @@ void OpenGLDriver::destroyIndexBuffer(IndexBufferHandle handle)
     if (handle) {
         auto& gl = m_context;
         GLIndexBuffer* ib = handle_cast<GLIndexBuffer*>(handle);
-        gl.deleteBuffer(GL_ELEMENT_ARRAY_BUFFER, ib->gl.id);
+        if (ib->stream) {
+            m_streamBuffers.erase(
+                std::remove(m_streamBuffers.begin(), m_streamBuffers.end(), ib->stream.get()),
+                m_streamBuffers.end());
+        }
+        else {
+            gl.deleteBuffer(GL_ELEMENT_ARRAY_BUFFER, ib->gl.id);
+        }
         destruct(handle, ib);
     }
 }
@@ -197,6 +229,16 @@ void OpenGLDriver::destroyProgram(ProgramHandle handle)
     }
 }
 
+void OpenGLDriver::destroyRenderPrimitive(RenderPrimitiveHandle handle)
+{
+    if (handle) {
+        auto& gl = m_context;
+        GLRenderPrimitive* rp = handle_cast<GLRenderPrimitive*>(handle);
+        gl.deleteVertexArray(rp->gl.vao);
+        destruct(handle, rp);
+    }
+}
+
 void OpenGLDriver::bindPipeline(const PipelineState& state)
 {
     auto& gl = m_context;
@@ -235,11 +277,18 @@ void OpenGLDriver::updateBufferData(VertexBufferHandle handle, const void* data,
 
     gl.bindVertexArray(nullptr);
 
+    assert(!vb->stream);
+
     gl.bindBuffer(GL_ARRAY_BUFFER, vb->gl.id);
     if (offset == 0 && vb->byteCount == size) {
         glBufferData(GL_ARRAY_BUFFER, size, data, OpenGLUtility::getBufferUsage(vb->usage));
     }
     else {
+        if (offset == 0 && vb->usage == BufferUsage::DYNAMIC) {
+            // Orphan the storage instead of waiting for the GPU to be done with it
+            glBufferData(GL_ARRAY_BUFFER, vb->byteCount, nullptr,
+                         OpenGLUtility::getBufferUsage(vb->usage));
+        }
         glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
     }
 
@@ -254,12 +303,43 @@ void OpenGLDriver::updateIndexBufferData(IndexBufferHandle handle, const void* d
 
     gl.bindVertexArray(nullptr);
 
+    assert(!ib->stream);
+
     gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ib->gl.id);
+    if (offset == 0 && ib->usage == BufferUsage::DYNAMIC) {
+        // Orphan the storage instead of waiting for the GPU to be done with it
+        const GLsizeiptr byteCount = static_cast<GLsizeiptr>(ib->elementSize) * ib->count;
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, byteCount, nullptr,
+                     OpenGLUtility::getBufferUsage(ib->usage));
+    }
     glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, size, data);
 
     CHECK_GL_ERROR(std::cerr);
 }
 
+size_t OpenGLDriver::streamBufferData(VertexBufferHandle handle, const void* data, size_t size,
+                                      size_t alignment)
+{
+    GLVertexBuffer* vb = handle_cast<GLVertexBuffer*>(handle);
+    assert(vb->stream);
+    return vb->stream->write(data, size, alignment);
+}
+
+size_t OpenGLDriver::streamIndexBufferData(IndexBufferHandle handle, const void* data,
+                                           size_t size)
+{
+    GLIndexBuffer* ib = handle_cast<GLIndexBuffer*>(handle);
+    assert(ib->stream);
+    return ib->stream->write(data, size, ib->elementSize);
+}
+
+void OpenGLDriver::endFrame()
+{
+    for (OpenGLStreamBuffer* stream : m_streamBuffers) {
+        stream->endFrame();
+    }
+}
+
 void OpenGLDriver::updateTextureImage(TextureHandle handle, uint8_t level, uint32_t xoffset,
                                       uint32_t yoffset, uint32_t zoffset, uint32_t width,
                                       uint32_t height, uint32_t depth, PixelBufferDescriptor&& data)
@@ -336,7 +416,7 @@ void OpenGLDriver::setSamplerParameters(TextureHandle handle, SamplerParameters
 }
 
 void OpenGLDriver::draw(PipelineState state, RenderPrimitiveHandle rph, const uint32_t indexOffset,
-                        const uint32_t indexCount)
+                        const uint32_t indexCount, const int32_t baseVertex)
 {
     GLRenderPrimitive* const rp = handle_cast<GLRenderPrimitive*>(rph);
     state.primitiveType = rp->type;
@@ -344,8 +424,15 @@ void OpenGLDriver::draw(PipelineState state, RenderPrimitiveHandle rph, const ui
     bindPipeline(state);
     bindRenderPrimitive(rph);
 
-    glDrawElements(GLenum(rp->type), static_cast<GLsizei>(indexCount), rp->gl.getIndicesType(),
-                   reinterpret_cast<const void*>(static_cast<uintptr_t>(indexOffset)));
+    const void* indices = reinterpret_cast<const void*>(static_cast<uintptr_t>(indexOffset));
+    if (baseVertex != 0) {
+        glDrawElementsBaseVertex(GLenum(rp->type), static_cast<GLsizei>(indexCount),
+                                 rp->gl.getIndicesType(), indices, baseVertex);
+    }
+    else {
+        glDrawElements(GLenum(rp->type), static_cast<GLsizei>(indexCount),
+                       rp->gl.getIndicesType(), indices);
+    }
 }
 
 void OpenGLDriver::updateVertexArrayObject(GLRenderPrimitive* rp, GLVertexBuffer* vb)
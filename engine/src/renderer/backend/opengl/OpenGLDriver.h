@@ -3,7 +3,10 @@
 #include "renderer/backend/DriverBase.h"
 #include "renderer/backend/HandleAllocator.h"
 #include "OpenGLContext.h"
+#include "OpenGLStreamBuffer.h"
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace ocf::backend {
 
@@ -30,6 +33,7 @@ public:
         } gl;
         BufferUsage usage = BufferUsage::DYNAMIC;
         Handle<HwVertexBufferInfo> vbih;
+        std::unique_ptr<OpenGLStreamBuffer> stream; // Only with BufferUsage::STREAM
 
         GLVertexBuffer() noexcept = default;
         GLVertexBuffer(uint32_t vertexCount, uint32_t byteCount, BufferUsage usage,
@@ -46,6 +50,7 @@ public:
             GLuint id = 0;
         } gl;
         BufferUsage usage = BufferUsage::STATIC;
+        std::unique_ptr<OpenGLStreamBuffer> stream; // Only with BufferUsage::STREAM
 
         GLIndexBuffer() noexcept = default;
         GLIndexBuffer(uint8_t elementSize, uint32_t indexCount, BufferUsage usage)
@@ -113,6 +118,8 @@ public:
 
     void destroyProgram(ProgramHandle handle) override;
 
+    void destroyRenderPrimitive(RenderPrimitiveHandle handle) override;
+
     void bindPipeline(const PipelineState& state) override;
 
     void bindRenderPrimitive(RenderPrimitiveHandle rph) override;
@@ -123,6 +130,14 @@ public:
     void updateIndexBufferData(IndexBufferHandle handle, const void* data, size_t size,
                                size_t offset) override;
 
+    size_t streamBufferData(VertexBufferHandle handle, const void* data, size_t size,
+                            size_t alignment) override;
+
+    size_t streamIndexBufferData(IndexBufferHandle handle, const void* data,
+                                 size_t size) override;
+
+    void endFrame() override;
+
     void updateTextureImage(TextureHandle handle, uint8_t level, uint32_t xoffset, uint32_t yoffset,
                             uint32_t zoffset, uint32_t width, uint32_t height, uint32_t depth,
                             PixelBufferDescriptor&& data) override;
@@ -132,7 +147,7 @@ public:
     void setSamplerParameters(TextureHandle handle, SamplerParameters parameter) override;
 
     void draw(PipelineState state, RenderPrimitiveHandle rph, const uint32_t indexOffset,
-              const uint32_t indexCount) override;
+              const uint32_t indexCount, const int32_t baseVertex) override;
 
 private:
     
@@ -184,6 +199,7 @@ private:
 private:
     OpenGLContext m_context;
     HandleAllocatorGL m_handleAllocator;
+    std::vector<OpenGLStreamBuffer*> m_streamBuffers;   // Recycled at the end of each frame
 };
 
 } // namespace ocf::backend
@@ -0,0 +1,139 @@
+#include "OpenGLStreamBuffer.h"
+
+#include "OpenGLContext.h"
+#include "platform/PlatformMacros.h"
+
+#include <string.h>
+
+namespace ocf::backend {
+
+// How long to wait for a fence before checking again, in nanoseconds
+static constexpr GLuint64 FENCE_TIMEOUT = 1000000000;
+
+OpenGLStreamBuffer::OpenGLStreamBuffer(OpenGLContext& context, GLenum target, size_t size)
+    : m_context(context)
+    , m_target(target)
+    , m_size(size)
+{
+    // Don't change the element array buffer of the bound vertex array
+    m_context.bindVertexArray(nullptr);
+
+    glGenBuffers(1, &m_id);
+    m_context.bindBuffer(m_target, m_id);
+
+    if (GLAD_GL_VERSION_4_4) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        const GLsizeiptr totalSize = static_cast<GLsizeiptr>(m_size * FRAME_COUNT);
+        glBufferStorage(m_target, totalSize, nullptr, flags);
+        m_mapped = static_cast<uint8_t*>(glMapBufferRange(m_target, 0, totalSize, flags));
+
+        if (m_mapped == nullptr) {
+            // The storage is immutable, start over with a new buffer
+            m_context.deleteBuffer(m_target, m_id);
+            glGenBuffers(1, &m_id);
+            m_context.bindBuffer(m_target, m_id);
+        }
+    }
+
+    if (m_mapped == nullptr) {
+        glBufferData(m_target, static_cast<GLsizeiptr>(m_size), nullptr, GL_STREAM_DRAW);
+    }
+}
+
+OpenGLStreamBuffer::~OpenGLStreamBuffer()
+{
+    for (GLsync& fence : m_fences) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    if (m_mapped != nullptr) {
+        m_context.bindVertexArray(nullptr);
+        m_context.bindBuffer(m_target, m_id);
+        glUnmapBuffer(m_target);
+    }
+    m_context.deleteBuffer(m_target, m_id);
+}
+
+size_t OpenGLStreamBuffer::write(const void* data, size_t size, size_t alignment)
+{
+    if (size > m_size) {
+        OCF_LOG_ERROR("Stream buffer of {} bytes per frame can't hold {} bytes", m_size, size);
+        return INVALID_OFFSET;
+    }
+
+    const size_t base = isPersistent() ? m_segment * m_size : 0;
+    size_t offset = (base + m_head + alignment - 1) / alignment * alignment - base;
+
+    if (offset + size > m_size) {
+        if (isPersistent()) {
+            // The other segments may still be read by the GPU, and waiting for the GPU
+            // to be done with this one would stall the frame
+            OCF_LOG_ERROR("Stream buffer of {} bytes per frame exhausted, dropping {} bytes",
+                          m_size, size);
+            return INVALID_OFFSET;
+        }
+        else {
+            // Orphan the storage, the GPU keeps reading the old one
+            m_context.bindVertexArray(nullptr);
+            m_context.bindBuffer(m_target, m_id);
+            glBufferData(m_target, static_cast<GLsizeiptr>(m_size), nullptr, GL_STREAM_DRAW);
+        }
+        offset = (base + alignment - 1) / alignment * alignment - base;
+    }
+
+    if (isPersistent()) {
+        memcpy(m_mapped + base + offset, data, size);
+    }
+    else {
+        // The range was never written since the last orphaning, no need to synchronize
+        m_context.bindVertexArray(nullptr);
+        m_context.bindBuffer(m_target, m_id);
+        const GLbitfield access =
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+        void* p = glMapBufferRange(m_target, static_cast<GLintptr>(offset),
+                                   static_cast<GLsizeiptr>(size), access);
+        if (p != nullptr) {
+            memcpy(p, data, size);
+            glUnmapBuffer(m_target);
+        }
+    }
+
+    m_head = offset + size;
+    return base + offset;
+}
+
+void OpenGLStreamBuffer::endFrame()
+{
+    if (!isPersistent()) {
+        return;
+    }
+
+    if (m_head > 0) {
+        m_fences[m_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    m_segment = (m_segment + 1) % FRAME_COUNT;
+    m_head = 0;
+    waitForSegment(m_segment);
+}
+
+void OpenGLStreamBuffer::waitForSegment(uint32_t segment)
+{
+    GLsync& fence = m_fences[segment];
+    if (fence == nullptr) {
+        return;
+    }
+
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+} // namespace ocf::backend
@@ -0,0 +1,81 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace ocf::backend {
+
+class OpenGLContext;
+
+/**
+ * @brief Buffer object written with new data every frame without stalling
+ *
+ * Writes are appended to the buffer, so they never touch data the GPU may
+ * still be reading.
+ *
+ * With GL 4.4 the buffer holds FRAME_COUNT segments of the requested size and
+ * is mapped persistently. Each frame writes into its own segment, which is
+ * fenced at the end of the frame and only reused once the fence is signaled.
+ * The size must therefore cover everything written in a frame: writes that
+ * don't fit in the segment fail rather than waiting for the GPU.
+ *
+ * Otherwise the buffer has the requested size and is orphaned when it is full,
+ * the driver then keeps the old storage alive until the GPU is done with it.
+ */
+class OpenGLStreamBuffer {
+public:
+    // Number of frames the GPU may lag behind
+    static constexpr uint32_t FRAME_COUNT = 3;
+
+    // Returned by write() when the data doesn't fit
+    static constexpr size_t INVALID_OFFSET = SIZE_MAX;
+
+    /**
+     * @brief Constructor
+     *
+     * @param target GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+     * @param size Number of bytes that can be written per frame, at least the total
+     *             size of the writes of a frame
+     */
+    OpenGLStreamBuffer(OpenGLContext& context, GLenum target, size_t size);
+    ~OpenGLStreamBuffer();
+
+    // Non-copyable
+    OpenGLStreamBuffer(const OpenGLStreamBuffer&) = delete;
+    OpenGLStreamBuffer& operator=(const OpenGLStreamBuffer&) = delete;
+
+    /**
+     * @brief Append data to the buffer
+     *
+     * @param data Data to copy
+     * @param size Size of the data in bytes
+     * @param alignment Alignment of the returned offset
+     * @return Byte offset of the data in the buffer, INVALID_OFFSET if the
+     *         frame's segment is full
+     */
+    size_t write(const void* data, size_t size, size_t alignment);
+
+    /**
+     * @brief Fence the data written in this frame and move on to the next segment
+     */
+    void endFrame();
+
+    GLuint getId() const { return m_id; }
+
+    bool isPersistent() const { return m_mapped != nullptr; }
+
+private:
+    void waitForSegment(uint32_t segment);
+
+    OpenGLContext& m_context;
+    GLenum m_target;
+    GLuint m_id = 0;
+    size_t m_size;          // Size of a segment
+    uint8_t* m_mapped = nullptr;
+
+    uint32_t m_segment = 0; // Segment written in this frame
+    size_t m_head = 0;      // Write position in the segment
+    GLsync m_fences[FRAME_COUNT] = {};
+};
+
+} // namespace ocf::backend
@@ -205,6 +205,7 @@ constexpr GLenum getBufferUsage(const BufferUsage usage)
     switch (usage) {
     case BufferUsage::STATIC:   return GL_STATIC_DRAW;
     case BufferUsage::DYNAMIC:  return GL_DYNAMIC_DRAW;
+    case BufferUsage::STREAM:   return GL_STREAM_DRAW;
     default:                    return GL_NONE;
     }
 }
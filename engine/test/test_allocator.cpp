@@ -1,8 +1,11 @@
 #include "ocf/core/Allocator.h"
+#include "ocf/core/FrameAllocator.h"
 #include <algorithm>
 #include <cstdint>
 #include <gtest/gtest.h>
 #include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 using namespace ocf;
@@ -175,3 +178,318 @@ TEST(LinearAllocatorTest, AllocFree)
     }
 }
 
+TEST(BumpAllocatorTest, AllocAlignment)
+{
+    alignas(64) char buffer[256];
+    BumpAllocator allocator(buffer, buffer + sizeof(buffer));
+
+    void* a = allocator.alloc(3, 1);
+    EXPECT_EQ(a, buffer);
+    void* b = allocator.alloc(16, 16);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 16, 0u);
+    EXPECT_EQ(b, buffer + 16);
+    EXPECT_EQ(allocator.getAllocatedSize(), 32u);
+
+    // Doesn't fit
+    EXPECT_EQ(allocator.alloc(sizeof(buffer)), nullptr);
+    EXPECT_EQ(allocator.getAllocatedSize(), 32u);
+    EXPECT_EQ(allocator.alloc(allocator.getAvailableSize(), 1), buffer + 32);
+}
+
+TEST(BumpAllocatorTest, RewindReset)
+{
+    LinearAllocator<BumpAllocator> allocator("TestAllocator", 256);
+
+    void* first = allocator.alloc(32);
+    void* mark = allocator.getCurrent();
+    void* second = allocator.alloc(64);
+    EXPECT_NE(second, nullptr);
+
+    allocator.rewind(mark);
+    EXPECT_EQ(allocator.alloc(64), second);
+
+    allocator.reset();
+    EXPECT_EQ(allocator.alloc(32), first);
+    EXPECT_EQ(allocator.getAllocator().getAllocatedSize(), 32u);
+}
+
+TEST(FrameAllocatorTest, NextFrame)
+{
+    FrameAllocator allocator("TestFrameAllocator", 256, 2);
+    EXPECT_EQ(allocator.getFrameCount(), 2u);
+
+    void* frame0 = allocator.alloc(64);
+    allocator.nextFrame();
+    void* frame1 = allocator.alloc(64);
+    EXPECT_NE(frame0, frame1);
+    EXPECT_EQ(allocator.getAllocatedSize(), 64u);
+
+    // Back to the first area, which has been reset
+    allocator.nextFrame();
+    EXPECT_EQ(allocator.getFrameIndex(), 0u);
+    EXPECT_EQ(allocator.getAllocatedSize(), 0u);
+    EXPECT_EQ(allocator.alloc(64), frame0);
+}
+
+TEST(FrameAllocatorTest, Overflow)
+{
+    FrameAllocator allocator("TestFrameAllocator", 64, 2);
+    EXPECT_NE(allocator.alloc(64), nullptr);
+
+    void* p = allocator.alloc(128, 32);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 32, 0u);
+    EXPECT_EQ(allocator.getOverflowSize(), 128u);
+
+    allocator.nextFrame();
+    allocator.nextFrame();
+    EXPECT_EQ(allocator.getOverflowSize(), 0u);
+}
+
+TEST(STLAllocatorTest, Vector)
+{
+    FrameAllocator allocator("TestFrameAllocator", 4096, 2);
+    FrameVector<uint32_t> values(allocator);
+    for (uint32_t i = 0; i < 100; ++i) {
+        values.push_back(i);
+    }
+    for (uint32_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(values[i], i);
+    }
+    EXPECT_GE(allocator.getAllocatedSize(), 100 * sizeof(uint32_t));
+    EXPECT_EQ(allocator.getOverflowSize(), 0u);
+}
+
+TEST(AtomicFreeListTest, PushPop)
+{
+    constexpr size_t elementSize = 16;
+    constexpr size_t alignment = alignof(std::max_align_t);
+    alignas(alignment) char buffer[elementSize * 4] = {};
+    AtomicFreeList list(buffer, buffer + sizeof(buffer), elementSize, alignment, 0);
+
+    void* nodes[4] = {};
+    for (int i = 0; i < 4; ++i) {
+        nodes[i] = list.pop();
+        EXPECT_NE(nodes[i], nullptr);
+    }
+    EXPECT_EQ(list.pop(), nullptr);
+
+    list.push(nodes[2]);
+    list.push(nodes[0]);
+    EXPECT_EQ(list.pop(), nodes[0]);
+    EXPECT_EQ(list.pop(), nodes[2]);
+    EXPECT_EQ(list.pop(), nullptr);
+}
+
+// Allocate and free from several threads, every block must be owned by one thread at a time
+template <typename Pool>
+void testConcurrentPool(Pool& pool)
+{
+    constexpr int NUM_THREADS = 4;
+    constexpr int ITERATIONS = 2000;
+    std::atomic<int> errors{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&, t]() {
+            std::vector<uint32_t*> blocks;
+            for (int i = 0; i < ITERATIONS; ++i) {
+                for (int j = 0; j < 8; ++j) {
+                    auto* p = static_cast<uint32_t*>(pool.alloc());
+                    if (p) {
+                        *p = static_cast<uint32_t>(t);
+                        blocks.push_back(p);
+                    }
+                }
+                for (uint32_t* p : blocks) {
+                    if (*p != static_cast<uint32_t>(t)) {
+                        errors.fetch_add(1);
+                    }
+                    pool.free(p);
+                }
+                blocks.clear();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(errors.load(), 0);
+}
+
+TEST(AtomicMemoryPoolTest, ConcurrentAllocFree)
+{
+    constexpr size_t elementSize = 32;
+    constexpr size_t elementCount = 64;
+    AreaPolicy::HeapArea area(elementSize * elementCount);
+    AtomicMemoryPool<elementSize> pool(area);
+
+    testConcurrentPool(pool);
+
+    // Every block is back in the pool
+    std::vector<void*> blocks;
+    while (void* p = pool.alloc()) {
+        blocks.push_back(p);
+    }
+    EXPECT_EQ(blocks.size(), elementCount);
+}
+
+TEST(ThreadCachedMemoryPoolTest, AllocFree)
+{
+    constexpr size_t elementSize = 32;
+    char buffer[elementSize * 8];
+    ThreadCachedMemoryPool<elementSize, alignof(std::max_align_t), 0, 4> pool(buffer,
+                                                                             sizeof(buffer));
+
+    std::vector<void*> blocks;
+    while (void* p = pool.alloc()) {
+        blocks.push_back(p);
+    }
+    EXPECT_EQ(blocks.size(), 8u);
+    std::sort(blocks.begin(), blocks.end());
+    EXPECT_EQ(std::unique(blocks.begin(), blocks.end()), blocks.end());
+
+    for (void* p : blocks) {
+        pool.free(p);
+    }
+    pool.flushThreadCache();
+    EXPECT_NE(pool.alloc(), nullptr);
+}
+
+TEST(ThreadCachedMemoryPoolTest, ConcurrentAllocFree)
+{
+    constexpr size_t elementSize = 32;
+    constexpr size_t elementCount = 256;
+    AreaPolicy::HeapArea area(elementSize * elementCount);
+    ThreadCachedMemoryPool<elementSize> pool(area);
+
+    testConcurrentPool(pool);
+}
+
+TEST(ThreadCachedMemoryPoolTest, ExitedThreadFlushesCache)
+{
+    constexpr size_t elementSize = 32;
+    char buffer[elementSize * 8];
+    ThreadCachedMemoryPool<elementSize, alignof(std::max_align_t), 0, 4> pool(buffer,
+                                                                             sizeof(buffer));
+
+    std::thread([&pool] { pool.free(pool.alloc()); }).join();
+
+    size_t count = 0;
+    while (pool.alloc()) {
+        ++count;
+    }
+    EXPECT_EQ(count, 8u);
+}
+
+TEST(ThreadCachedMemoryPoolTest, ExitedThreadReleasesIndex)
+{
+    for (uint32_t i = 0; i < threadcache::MAX_THREADS * 2; ++i) {
+        uint32_t index = threadcache::MAX_THREADS;
+        std::thread([&index] { index = threadcache::getThreadIndex(); }).join();
+        EXPECT_LT(index, threadcache::MAX_THREADS);
+    }
+}
+
+TEST(AllocatorTrackingTest, MemoryPool)
+{
+    using TrackedPool =
+        LinearAllocator<MemoryPool<32>, AreaPolicy::HeapArea, TrackingPolicy::Tracked>;
+    TrackedPool allocator("TrackedPool", 32 * 4);
+
+    void* blocks[4];
+    for (void*& p : blocks) {
+        p = allocator.alloc();
+    }
+    EXPECT_EQ(allocator.alloc(), nullptr);
+    allocator.free(blocks[0]);
+    allocator.free(blocks[1]);
+
+    AllocatorStats stats = allocator.getTracking().getStats();
+    EXPECT_STREQ(stats.name, "TrackedPool");
+    EXPECT_EQ(stats.capacity, 32u * 4);
+    EXPECT_EQ(stats.liveCount, 2u);
+    EXPECT_EQ(stats.liveBytes, 64u);
+    EXPECT_EQ(stats.peakCount, 4u);
+    EXPECT_EQ(stats.peakBytes, 128u);
+    EXPECT_EQ(stats.allocationCount, 4u);
+    EXPECT_EQ(stats.failureCount, 1u);
+}
+
+TEST(AllocatorTrackingTest, BumpAllocatorRewindReset)
+{
+    LinearAllocator<BumpAllocator, AreaPolicy::HeapArea, TrackingPolicy::Tracked> allocator(
+        "TrackedBump", 256);
+
+    allocator.alloc(16);
+    void* mark = allocator.getCurrent();
+    allocator.alloc(32);
+    allocator.alloc(64);
+    EXPECT_EQ(allocator.getTracking().getStats().liveBytes, 112u);
+
+    allocator.rewind(mark);
+    EXPECT_EQ(allocator.getTracking().getStats().liveBytes, 16u);
+    EXPECT_EQ(allocator.getTracking().getStats().liveCount, 1u);
+
+    allocator.reset();
+    EXPECT_EQ(allocator.getTracking().getStats().liveBytes, 0u);
+    EXPECT_EQ(allocator.getTracking().getStats().peakBytes, 112u);
+}
+
+TEST(AllocatorTrackingTest, TrackerGroupsByName)
+{
+    using TrackedPool =
+        LinearAllocator<MemoryPool<32>, AreaPolicy::HeapArea, TrackingPolicy::Tracked>;
+    auto findStats = [](const char* name) {
+        for (const AllocatorStats& stats : AllocatorTracker::getStats()) {
+            if (std::string(stats.name) == name) {
+                return stats;
+            }
+        }
+        return AllocatorStats{};
+    };
+
+    {
+        TrackedPool first("SharedName", 64);
+        TrackedPool second("SharedName", 128);
+        first.alloc();
+        second.alloc();
+        second.alloc();
+
+        AllocatorStats stats = findStats("SharedName");
+        EXPECT_EQ(stats.capacity, 192u);
+        EXPECT_EQ(stats.liveCount, 3u);
+        EXPECT_EQ(stats.liveBytes, 96u);
+        AllocatorTracker::logStats();
+    }
+
+    // Unregistered on destruction
+    EXPECT_EQ(findStats("SharedName").name, nullptr);
+}
+
+TEST(GrowingMemoryPoolTest, GrowsWhenExhausted)
+{
+    GrowingMemoryPool<48> pool(4);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 20; ++i) {
+        void* p = pool.alloc();
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(std::max_align_t), 0u);
+        blocks.push_back(p);
+    }
+    // 4 + 8 + 16 blocks
+    EXPECT_EQ(pool.getChunkCount(), 3u);
+    EXPECT_EQ(pool.getCapacity(), 28u);
+
+    std::sort(blocks.begin(), blocks.end());
+    EXPECT_EQ(std::unique(blocks.begin(), blocks.end()), blocks.end());
+
+    // Freed blocks are reused before growing again
+    for (void* p : blocks) {
+        pool.free(p);
+    }
+    for (int i = 0; i < 28; ++i) {
+        pool.alloc();
+    }
+    EXPECT_EQ(pool.getChunkCount(), 3u);
+}
@@ -0,0 +1,205 @@
+#include "renderer/backend/HandleAllocator.h"
+
+#include <gtest/gtest.h>
+#include <csignal>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace ocf::backend;
+
+namespace {
+
+struct SmallObject {
+    explicit SmallObject(uint32_t v) : value(v) {}
+    uint32_t value;
+};
+
+struct LargeObject {
+    explicit LargeObject(uint32_t v) : value(v) {}
+    uint32_t value;
+    char padding[150];
+};
+
+// Fits only a few objects of each size, forcing the arena to grow
+constexpr size_t INITIAL_SIZE = 4096;
+
+} // namespace
+
+TEST(HandleAllocatorTest, AllocateAndCast)
+{
+    HandleAllocatorGL allocator("TestHandles", INITIAL_SIZE);
+
+    Handle<SmallObject> handle = allocator.allocateAndConstruct<SmallObject>(42u);
+    ASSERT_TRUE(handle);
+    SmallObject* object = allocator.handle_cast<SmallObject*>(handle);
+    EXPECT_EQ(object->value, 42u);
+
+    allocator.deallocate(handle, object);
+}
+
+TEST(HandleAllocatorTest, NullHandleCast)
+{
+    HandleAllocatorGL allocator("TestHandles", INITIAL_SIZE);
+
+    Handle<SmallObject> handle;
+    EXPECT_FALSE(handle);
+    EXPECT_EQ(allocator.handle_cast<SmallObject*>(handle), nullptr);
+}
+
+TEST(HandleAllocatorTest, GrowPastInitialSize)
+{
+    HandleAllocatorGL allocator("TestHandles", INITIAL_SIZE);
+
+    constexpr uint32_t COUNT = 2000;
+    std::vector<Handle<SmallObject>> small;
+    std::vector<Handle<LargeObject>> large;
+    std::set<void*> addresses;
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        small.push_back(allocator.allocateAndConstruct<SmallObject>(i));
+        large.push_back(allocator.allocateAndConstruct<LargeObject>(i));
+        addresses.insert(allocator.handle_cast<SmallObject*>(small.back()));
+        addresses.insert(allocator.handle_cast<LargeObject*>(large.back()));
+    }
+    // Far more than the initial arena holds, every object has its own slot
+    EXPECT_EQ(addresses.size(), 2u * COUNT);
+
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        EXPECT_EQ(allocator.handle_cast<SmallObject*>(small[i])->value, i);
+        EXPECT_EQ(allocator.handle_cast<LargeObject*>(large[i])->value, i);
+    }
+
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        allocator.deallocate(small[i], allocator.handle_cast<SmallObject*>(small[i]));
+        allocator.deallocate(large[i], allocator.handle_cast<LargeObject*>(large[i]));
+    }
+
+    // Freed slots are reused, in the initial chunk first
+    Handle<SmallObject> handle = allocator.allocateAndConstruct<SmallObject>(7u);
+    EXPECT_EQ(allocator.handle_cast<SmallObject*>(handle)->value, 7u);
+    EXPECT_EQ(addresses.count(allocator.handle_cast<SmallObject*>(handle)), 1u);
+    allocator.deallocate(handle, allocator.handle_cast<SmallObject*>(handle));
+}
+
+TEST(HandleAllocatorTest, ReuseSlotOfEarlierChunk)
+{
+    HandleAllocatorGL allocator("TestHandles", INITIAL_SIZE);
+
+    constexpr uint32_t COUNT = 2000;
+    std::vector<Handle<SmallObject>> handles;
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        handles.push_back(allocator.allocateAndConstruct<SmallObject>(i));
+    }
+
+    // Allocations go on in the last chunk until a slot of the first one is freed
+    SmallObject* first = allocator.handle_cast<SmallObject*>(handles.front());
+    allocator.deallocate(handles.front(), first);
+    handles.front() = allocator.allocateAndConstruct<SmallObject>(0u);
+    EXPECT_EQ(allocator.handle_cast<SmallObject*>(handles.front()), first);
+
+    for (Handle<SmallObject>& handle : handles) {
+        allocator.deallocate(handle, allocator.handle_cast<SmallObject*>(handle));
+    }
+}
+
+TEST(HandleAllocatorTest, AgeChangesOnReuse)
+{
+    HandleAllocatorGL allocator("TestHandles", INITIAL_SIZE);
+
+    Handle<SmallObject> first = allocator.allocateAndConstruct<SmallObject>(1u);
+    const HandleBase::HandleId firstId = first.getId();
+    EXPECT_TRUE(allocator.isValid(firstId));
+    allocator.deallocate(first, allocator.handle_cast<SmallObject*>(first));
+    EXPECT_FALSE(allocator.isValid(firstId));
+
+    // The slot is reused with a new age, so the ids differ
+    Handle<SmallObject> second = allocator.allocateAndConstruct<SmallObject>(2u);
+    EXPECT_NE(second.getId(), firstId);
+    EXPECT_TRUE(allocator.isValid(second.getId()));
+    EXPECT_FALSE(allocator.isValid(firstId));
+    allocator.deallocate(second, allocator.handle_cast<SmallObject*>(second));
+}
+
+TEST(HandleAllocatorTest, ConcurrentAllocateAndDeallocate)
+{
+    HandleAllocatorGL allocator("TestHandles", INITIAL_SIZE);
+
+    constexpr uint32_t THREAD_COUNT = 4;
+    constexpr uint32_t COUNT = 500;
+    std::vector<std::vector<Handle<SmallObject>>> handles(THREAD_COUNT);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < THREAD_COUNT; ++t) {
+        threads.emplace_back([&, t]() {
+            // Free half of the handles again, so slots move between the threads' caches
+            for (uint32_t i = 0; i < COUNT; ++i) {
+                Handle<SmallObject> handle =
+                    allocator.allocateAndConstruct<SmallObject>(t * COUNT + i);
+                if (i % 2 == 0) {
+                    allocator.deallocate(handle, allocator.handle_cast<SmallObject*>(handle));
+                }
+                else {
+                    handles[t].push_back(handle);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::set<void*> addresses;
+    for (uint32_t t = 0; t < THREAD_COUNT; ++t) {
+        for (size_t i = 0; i < handles[t].size(); ++i) {
+            SmallObject* object = allocator.handle_cast<SmallObject*>(handles[t][i]);
+            EXPECT_EQ(object->value, t * COUNT + i * 2 + 1);
+            addresses.insert(object);
+        }
+    }
+    EXPECT_EQ(addresses.size(), THREAD_COUNT * COUNT / 2);
+
+    for (auto& threadHandles : handles) {
+        for (Handle<SmallObject>& handle : threadHandles) {
+            allocator.deallocate(handle, allocator.handle_cast<SmallObject*>(handle));
+        }
+    }
+}
+
+TEST(HandleAllocatorTest, NullHandleIsValid)
+{
+    HandleAllocatorGL allocator("TestHandles", INITIAL_SIZE);
+
+    EXPECT_TRUE(allocator.isValid(HandleBase::nullid));
+    EXPECT_TRUE(allocator.isValid(Handle<SmallObject>().getId()));
+}
+
+TEST(HandleAllocatorDeathTest, StaleHandleCast)
+{
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_DEATH(
+        {
+            HandleAllocatorGL allocator("TestHandles", INITIAL_SIZE);
+            Handle<SmallObject> handle = allocator.allocateAndConstruct<SmallObject>(1u);
+            Handle<SmallObject> stale = handle;
+            allocator.deallocate(handle, allocator.handle_cast<SmallObject*>(handle));
+            allocator.allocateAndConstruct<SmallObject>(2u);
+            allocator.handle_cast<SmallObject*>(stale);
+        },
+        "");
+}
+
+TEST(HandleAllocatorDeathTest, UnknownChunkHandleCast)
+{
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    auto castUnknownChunk = []() {
+        HandleAllocatorGL allocator("TestHandles", INITIAL_SIZE);
+        // Every index bit set: the last chunk, which is never allocated
+        Handle<SmallObject> handle((1u << 27) - 1u);
+        allocator.handle_cast<SmallObject*>(handle);
+    };
+#if defined(_WIN32)
+    EXPECT_DEATH(castUnknownChunk(), "");
+#else
+    // Reported and aborted, the report must not dereference the handle
+    EXPECT_EXIT(castUnknownChunk(), ::testing::KilledBySignal(SIGABRT), "");
+#endif
+}
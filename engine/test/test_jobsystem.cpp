@@ -1,12 +1,28 @@
+#include "ocf/core/job/EventCount.h"
 #include "ocf/core/job/Job.h"
+#include "ocf/core/job/JobFreeList.h"
 #include "ocf/core/job/JobSystem.h"
+#include "ocf/core/job/MpmcQueue.h"
+#include "ocf/core/job/Task.h"
+#include "ocf/core/job/TaskGraph.h"
 #include "ocf/core/job/WorkStealingQueue.h"
 
+#include <algorithm>
 #include <atomic>
 #include <gtest/gtest.h>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <vector>
 
+#if (OCF_TARGET_PLATFORM == OCF_PLATFORM_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 using namespace ocf::job;
 
 // ===========================================================================
@@ -43,6 +59,49 @@ TEST(JobTest, MoveConstruction)
     EXPECT_EQ(job1.data, nullptr);
 }
 
+TEST(JobFunctionTest, InlineCapture)
+{
+    int result = 0;
+    int a = 40;
+    int b = 2;
+    JobFunction function([&result, a, b](void*) { result = a + b; });
+
+    EXPECT_TRUE(function);
+    function(nullptr);
+    EXPECT_EQ(result, 42);
+}
+
+TEST(JobFunctionTest, MoveAndReset)
+{
+    auto counter = std::make_shared<int>(0);
+    JobFunction function1([counter](void*) { ++*counter; });
+    EXPECT_EQ(counter.use_count(), 2);
+
+    JobFunction function2(std::move(function1));
+    EXPECT_FALSE(function1);
+    EXPECT_TRUE(function2);
+    EXPECT_EQ(counter.use_count(), 2);
+
+    function2(nullptr);
+    EXPECT_EQ(*counter, 1);
+
+    function2.reset();
+    EXPECT_FALSE(function2);
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(JobFunctionTest, FunctionPointer)
+{
+    static int calls = 0;
+    struct Local {
+        static void run(void*) { ++calls; }
+    };
+
+    JobFunction function(&Local::run);
+    function(nullptr);
+    EXPECT_EQ(calls, 1);
+}
+
 TEST(JobTest, JobPriorities)
 {
     EXPECT_LT(static_cast<uint8_t>(JobPriority::Low), static_cast<uint8_t>(JobPriority::Normal));
@@ -128,15 +187,26 @@ TEST(WorkStealingQueueTest, Steal)
     EXPECT_EQ(item.value(), 2);
 }
 
-TEST(WorkStealingQueueTest, Full)
+TEST(WorkStealingQueueTest, Grow)
 {
     WorkStealingQueue<int, 4> queue;
+    EXPECT_EQ(queue.capacity(), 4u);
 
     EXPECT_TRUE(queue.push(1));
     EXPECT_TRUE(queue.push(2));
     EXPECT_TRUE(queue.push(3));
     EXPECT_TRUE(queue.push(4));
-    EXPECT_FALSE(queue.push(5));  // Queue is full
+    EXPECT_TRUE(queue.push(5));  // Queue grows instead of failing
+    EXPECT_EQ(queue.capacity(), 8u);
+    EXPECT_EQ(queue.size(), 5u);
+
+    // Order is preserved across the growth
+    EXPECT_EQ(queue.steal().value(), 1);
+    EXPECT_EQ(queue.pop().value(), 5);
+    EXPECT_EQ(queue.pop().value(), 4);
+    EXPECT_EQ(queue.steal().value(), 2);
+    EXPECT_EQ(queue.pop().value(), 3);
+    EXPECT_FALSE(queue.pop().has_value());
 }
 
 TEST(WorkStealingQueueTest, Empty)
@@ -150,6 +220,190 @@ TEST(WorkStealingQueueTest, Empty)
     EXPECT_FALSE(item.has_value());
 }
 
+// ===========================================================================
+// MpmcQueue Tests
+// ===========================================================================
+
+TEST(MpmcQueueTest, PushPopFifo)
+{
+    MpmcQueue<int> queue(4);
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.capacity(), 4u);
+
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_TRUE(queue.push(3));
+    EXPECT_TRUE(queue.push(4));
+    EXPECT_FALSE(queue.push(5));  // Queue is full
+    EXPECT_EQ(queue.size(), 4u);
+
+    EXPECT_EQ(queue.pop().value(), 1);
+    EXPECT_EQ(queue.pop().value(), 2);
+    EXPECT_TRUE(queue.push(5));
+    EXPECT_EQ(queue.pop().value(), 3);
+    EXPECT_EQ(queue.pop().value(), 4);
+    EXPECT_EQ(queue.pop().value(), 5);
+    EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST(MpmcQueueTest, ConcurrentProducersConsumers)
+{
+    constexpr int NUM_PRODUCERS = 4;
+    constexpr int NUM_CONSUMERS = 4;
+    constexpr int ITEMS_PER_PRODUCER = 20000;
+    constexpr int TOTAL_ITEMS = NUM_PRODUCERS * ITEMS_PER_PRODUCER;
+
+    MpmcQueue<int> queue(256);
+    std::vector<std::atomic<int>> received(TOTAL_ITEMS);
+    for (auto& r : received) {
+        r.store(0, std::memory_order_relaxed);
+    }
+    std::atomic<int> consumed{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < NUM_PRODUCERS; ++p) {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < ITEMS_PER_PRODUCER; ++i) {
+                while (!queue.push(p * ITEMS_PER_PRODUCER + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < NUM_CONSUMERS; ++c) {
+        threads.emplace_back([&]() {
+            while (consumed.load(std::memory_order_relaxed) < TOTAL_ITEMS) {
+                auto item = queue.pop();
+                if (item.has_value()) {
+                    received[item.value()].fetch_add(1, std::memory_order_relaxed);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // Every item was received exactly once
+    for (int i = 0; i < TOTAL_ITEMS; ++i) {
+        EXPECT_EQ(received[i].load(), 1) << "item " << i;
+    }
+}
+
+// ===========================================================================
+// JobFreeList Tests
+// ===========================================================================
+
+TEST(JobFreeListTest, AllocateFree)
+{
+    JobFreeList list(4);
+
+    std::vector<uint32_t> indices;
+    for (int i = 0; i < 4; ++i) {
+        uint32_t index = list.allocate();
+        EXPECT_LT(index, 4u);
+        indices.push_back(index);
+    }
+    EXPECT_EQ(list.allocate(), JobFreeList::INVALID_INDEX);  // Exhausted
+
+    list.free(indices[2]);
+    EXPECT_EQ(list.allocate(), indices[2]);
+}
+
+TEST(JobFreeListTest, ConcurrentAllocateFree)
+{
+    constexpr size_t CAPACITY = 64;
+    constexpr int NUM_THREADS = 4;
+    constexpr int NUM_ITERATIONS = 10000;
+
+    JobFreeList list(CAPACITY);
+    std::unique_ptr<std::atomic<int>[]> owners(new std::atomic<int>[CAPACITY]);
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        owners[i].store(0, std::memory_order_relaxed);
+    }
+    std::atomic<int> collisions{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < NUM_ITERATIONS; ++i) {
+                uint32_t index = list.allocate();
+                if (index == JobFreeList::INVALID_INDEX) {
+                    continue;
+                }
+                // An index must never be handed out twice at the same time
+                if (owners[index].fetch_add(1, std::memory_order_acq_rel) != 0) {
+                    collisions.fetch_add(1, std::memory_order_relaxed);
+                }
+                owners[index].fetch_sub(1, std::memory_order_acq_rel);
+                list.free(index);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(collisions.load(), 0);
+
+    // Every index is free again
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        EXPECT_NE(list.allocate(), JobFreeList::INVALID_INDEX);
+    }
+    EXPECT_EQ(list.allocate(), JobFreeList::INVALID_INDEX);
+}
+
+// ===========================================================================
+// EventCount Tests
+// ===========================================================================
+
+TEST(EventCountTest, NotifyBeforeCommitDoesNotBlock)
+{
+    EventCount eventCount;
+    EventCount::Key key = eventCount.prepareWait();
+    EXPECT_EQ(eventCount.getWaiterCount(), 1u);
+
+    eventCount.notify();
+    eventCount.commitWait(key);  // Must return immediately
+    EXPECT_EQ(eventCount.getWaiterCount(), 0u);
+}
+
+TEST(EventCountTest, NotifyWakesParkedThread)
+{
+    EventCount eventCount;
+    std::atomic<bool> ready{false};
+    std::atomic<bool> woken{false};
+
+    std::thread waiter([&]() {
+        while (!ready.load(std::memory_order_acquire)) {
+            EventCount::Key key = eventCount.prepareWait();
+            if (ready.load(std::memory_order_acquire)) {
+                eventCount.cancelWait();
+                break;
+            }
+            eventCount.commitWait(key);
+        }
+        woken.store(true, std::memory_order_release);
+    });
+
+    while (eventCount.getWaiterCount() == 0) {
+        std::this_thread::yield();
+    }
+    EXPECT_FALSE(woken.load(std::memory_order_acquire));
+
+    ready.store(true, std::memory_order_release);
+    eventCount.notify();
+    waiter.join();
+
+    EXPECT_TRUE(woken.load(std::memory_order_acquire));
+    EXPECT_EQ(eventCount.getWaiterCount(), 0u);
+}
+
 // ===========================================================================
 // JobSystem Tests
 // ===========================================================================
@@ -303,6 +557,25 @@ TEST_F(JobSystemTest, InvalidHandle)
     JobSystem::getInstance().wait(invalid);
 }
 
+TEST_F(JobSystemTest, PoolExhaustionAndReuse)
+{
+    // The fixture pool holds 256 jobs
+    std::vector<JobHandle> handles;
+    for (int i = 0; i < 256; ++i) {
+        auto handle = JobSystem::getInstance().createJob([](void*) {});
+        EXPECT_TRUE(handle.isValid());
+        handles.push_back(handle);
+    }
+    EXPECT_FALSE(JobSystem::getInstance().createJob([](void*) {}).isValid());
+
+    for (auto& handle : handles) {
+        JobSystem::getInstance().run(handle);
+    }
+    JobSystem::getInstance().waitAll();
+
+    EXPECT_TRUE(JobSystem::getInstance().createJob([](void*) {}).isValid());
+}
+
 TEST_F(JobSystemTest, JobPriorities)
 {
     auto lowPriority =
@@ -314,6 +587,522 @@ TEST_F(JobSystemTest, JobPriorities)
     EXPECT_TRUE(highPriority.isValid());
 }
 
+TEST_F(JobSystemTest, ConcurrentExternalProducers)
+{
+    constexpr int NUM_PRODUCERS = 4;
+    constexpr int JOBS_PER_PRODUCER = 2000;
+    auto& js = JobSystem::getInstance();
+    std::atomic<int> counter{0};
+
+    // Several non-worker threads submit to the global queues at the same time
+    std::vector<std::thread> producers;
+    for (int p = 0; p < NUM_PRODUCERS; ++p) {
+        producers.emplace_back([&, p]() {
+            JobPriority priority = static_cast<JobPriority>(p % JOB_PRIORITY_COUNT);
+            for (int i = 0; i < JOBS_PER_PRODUCER; ++i) {
+                JobHandle handle;
+                // The pool is small, retry until a slot is free
+                while (!(handle = js.createJob(
+                             [](void* data) {
+                                 static_cast<std::atomic<int>*>(data)->fetch_add(
+                                     1, std::memory_order_relaxed);
+                             },
+                             &counter, priority))
+                            .isValid()) {
+                    std::this_thread::yield();
+                }
+                js.run(handle);
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    js.waitAll();
+    EXPECT_EQ(counter.load(), NUM_PRODUCERS * JOBS_PER_PRODUCER);
+}
+
+#if OCF_JOB_COROUTINES
+
+namespace {
+
+Task<int> computeOnWorker(int value)
+{
+    co_await resumeOnJobSystem();
+    co_return value * 2;
+}
+
+Task<int> addComputed(int a, int b)
+{
+    int first = co_await computeOnWorker(a);
+    int second = co_await computeOnWorker(b);
+    co_return first + second;
+}
+
+Task<uint32_t> workerIdAfterResume()
+{
+    co_await resumeOnJobSystem();
+    co_return JobSystem::getInstance().getCurrentWorkerId();
+}
+
+Task<> throwOnWorker()
+{
+    co_await resumeOnJobSystem();
+    throw std::runtime_error("failed");
+}
+
+} // namespace
+
+TEST_F(JobSystemTest, TaskSyncWait)
+{
+    EXPECT_EQ(syncWait(computeOnWorker(21)), 42);
+    EXPECT_EQ(syncWait(addComputed(1, 2)), 6);
+}
+
+TEST_F(JobSystemTest, TaskRunsInlineWhenPoolExhausted)
+{
+    // The fixture pool holds 256 jobs
+    std::vector<JobHandle> handles;
+    for (int i = 0; i < 256; ++i) {
+        handles.push_back(JobSystem::getInstance().createJob([](void*) {}));
+    }
+
+    // No job can be created to resume on, the task continues on this thread
+    EXPECT_EQ(syncWait(workerIdAfterResume()), UINT32_MAX);
+
+    for (auto& handle : handles) {
+        JobSystem::getInstance().run(handle);
+    }
+    JobSystem::getInstance().waitAll();
+}
+
+TEST_F(JobSystemTest, TaskWhenAll)
+{
+    constexpr int NUM_TASKS = 32;
+    std::vector<Task<int>> tasks;
+    for (int i = 0; i < NUM_TASKS; ++i) {
+        tasks.push_back(computeOnWorker(i));
+    }
+
+    std::vector<int> results = syncWait(whenAll(std::move(tasks)));
+    ASSERT_EQ(results.size(), static_cast<size_t>(NUM_TASKS));
+    for (int i = 0; i < NUM_TASKS; ++i) {
+        EXPECT_EQ(results[i], i * 2);
+    }
+
+    EXPECT_TRUE(syncWait(whenAll(std::vector<Task<int>>())).empty());
+}
+
+TEST_F(JobSystemTest, TaskPropagatesException)
+{
+    EXPECT_THROW(syncWait(throwOnWorker()), std::runtime_error);
+
+    std::vector<Task<>> tasks;
+    tasks.push_back(throwOnWorker());
+    EXPECT_THROW(syncWait(whenAll(std::move(tasks))), std::runtime_error);
+}
+
+#endif // OCF_JOB_COROUTINES
+
+TEST(JobSystemTopologyTest, AvailableCores)
+{
+    std::vector<int32_t> cores = JobSystem::getAvailableCores();
+    ASSERT_FALSE(cores.empty());
+    EXPECT_TRUE(std::is_sorted(cores.begin(), cores.end()));
+}
+
+TEST(JobSystemTopologyTest, PinnedNamedWorkers)
+{
+    JobSystemConfig config;
+    config.numWorkers = 2;
+    config.maxJobs = 64;
+    config.pinWorkers = true;
+    config.threadName = "TestWorker";
+    config.stackSize = 256 * 1024;
+
+    auto& js = JobSystem::getInstance();
+    js.initialize(config);
+
+    // Captured by reference as a whole, job functions hold two pointers at most
+    struct Counts {
+        std::atomic<int> onWorker{0};
+        std::atomic<int> pinned{0};
+        std::atomic<int> named{0};
+    } counts;
+    JobHandle root = js.createJob([](void*) {});
+    for (int i = 0; i < 16; ++i) {
+        JobHandle child = js.createJobAsChild(root, [&js, &counts](void*) {
+            if (js.getCurrentWorkerId() == UINT32_MAX) {
+                return;  // Run by the waiting thread
+            }
+            counts.onWorker.fetch_add(1);
+#if (OCF_TARGET_PLATFORM == OCF_PLATFORM_LINUX)
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0 && CPU_COUNT(&cpuSet) == 1) {
+                counts.pinned.fetch_add(1);
+            }
+            char name[16] = {};
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+            if (std::string(name).rfind("TestWorker ", 0) == 0) {
+                counts.named.fetch_add(1);
+            }
+#else
+            counts.pinned.fetch_add(1);
+            counts.named.fetch_add(1);
+#endif
+        });
+        js.run(child);
+    }
+    js.run(root);
+    js.wait(root);
+
+    EXPECT_EQ(counts.pinned.load(), counts.onWorker.load());
+    EXPECT_EQ(counts.named.load(), counts.onWorker.load());
+    js.shutdown();
+}
+
+class JobSystemProfilingTest : public ::testing::Test {
+protected:
+    static constexpr int NUM_JOBS = 200;
+
+    void SetUp() override
+    {
+        JobSystemConfig config;
+        config.numWorkers = 2;
+        config.maxJobs = 256;
+        config.enableProfiling = true;
+        config.enableTimeline = true;
+        JobSystem::getInstance().initialize(config);
+    }
+
+    void TearDown() override { JobSystem::getInstance().shutdown(); }
+
+    // Submit from this thread and wait without helping, so that workers run every job
+    void runJobs(std::atomic<int>& counter)
+    {
+        auto& js = JobSystem::getInstance();
+        for (int i = 0; i < NUM_JOBS; ++i) {
+            JobHandle handle = js.createJob(
+                [](void* data) {
+                    static_cast<std::atomic<int>*>(data)->fetch_add(1, std::memory_order_relaxed);
+                },
+                &counter);
+            ASSERT_TRUE(handle.isValid());
+            js.run(handle);
+        }
+        while (counter.load() < NUM_JOBS) {
+            std::this_thread::yield();
+        }
+        js.waitAll();
+    }
+};
+
+TEST_F(JobSystemProfilingTest, CountsJobsPerWorker)
+{
+    auto& js = JobSystem::getInstance();
+    std::atomic<int> counter{0};
+    runJobs(counter);
+
+    uint64_t executed = 0;
+    for (uint32_t i = 0; i < js.getWorkerCount(); ++i) {
+        WorkerStats stats = js.getWorkerStats(i);
+        executed += stats.jobsExecuted;
+        EXPECT_LE(stats.stealsSucceeded, stats.stealsAttempted);
+        EXPECT_EQ(stats.queueDepth, 0u);
+    }
+    EXPECT_EQ(executed, static_cast<uint64_t>(NUM_JOBS));
+
+    js.resetStats();
+    EXPECT_EQ(js.getWorkerStats(0).jobsExecuted, 0u);
+    EXPECT_EQ(js.getWorkerStats(js.getWorkerCount()).jobsExecuted, 0u);
+}
+
+TEST_F(JobSystemProfilingTest, WritesChromeTrace)
+{
+    auto& js = JobSystem::getInstance();
+    js.resetStats();
+    std::atomic<int> counter{0};
+    runJobs(counter);
+
+    std::ostringstream out;
+    js.writeChromeTrace(out);
+    std::string trace = out.str();
+
+    EXPECT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(trace.find("\"name\":\"Worker 0\""), std::string::npos);
+
+    // One complete event per job
+    size_t events = 0;
+    for (size_t pos = trace.find("\"ph\":\"X\""); pos != std::string::npos;
+         pos = trace.find("\"ph\":\"X\"", pos + 1)) {
+        ++events;
+    }
+    EXPECT_EQ(events, static_cast<size_t>(NUM_JOBS));
+}
+
+// Helper struct for priority ordering test
+struct PriorityData {
+    std::atomic<int>* orderCounter;
+    std::atomic<int>* doneCounter;
+    int order;
+};
+
+TEST_F(JobSystemTest, HigherPriorityRunsFirst)
+{
+    constexpr int NUM_JOBS = 8;
+    auto& js = JobSystem::getInstance();
+
+    // Keep both workers busy while the jobs are queued
+    std::atomic<int> started{0};
+    std::atomic<bool> release{false};
+    struct BlockData {
+        std::atomic<int>* started;
+        std::atomic<bool>* release;
+    } blockData{&started, &release};
+
+    for (uint32_t i = 0; i < js.getWorkerCount(); ++i) {
+        auto blocker = js.createJob(
+            [](void* data) {
+                auto* d = static_cast<BlockData*>(data);
+                d->started->fetch_add(1, std::memory_order_acq_rel);
+                while (!d->release->load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+            },
+            &blockData);
+        js.run(blocker);
+    }
+    while (started.load(std::memory_order_acquire) < static_cast<int>(js.getWorkerCount())) {
+        std::this_thread::yield();
+    }
+
+    std::atomic<int> order{0};
+    std::atomic<int> done{0};
+    std::vector<PriorityData> lowData(NUM_JOBS, PriorityData{&order, &done, -1});
+    std::vector<PriorityData> criticalData(NUM_JOBS, PriorityData{&order, &done, -1});
+
+    auto function = [](void* data) {
+        auto* d = static_cast<PriorityData*>(data);
+        d->order = d->orderCounter->fetch_add(1, std::memory_order_acq_rel);
+        d->doneCounter->fetch_add(1, std::memory_order_acq_rel);
+    };
+
+    // Low priority work is submitted first
+    for (int i = 0; i < NUM_JOBS; ++i) {
+        js.run(js.createJob(function, &lowData[i], JobPriority::Low));
+    }
+    for (int i = 0; i < NUM_JOBS; ++i) {
+        js.run(js.createJob(function, &criticalData[i], JobPriority::Critical));
+    }
+
+    release.store(true, std::memory_order_release);
+
+    // Do not help from this thread, only the workers pick jobs
+    while (done.load(std::memory_order_acquire) < NUM_JOBS * 2) {
+        std::this_thread::yield();
+    }
+    js.waitAll();
+
+    int lastCritical = -1;
+    for (const auto& d : criticalData) {
+        lastCritical = std::max(lastCritical, d.order);
+    }
+    int lowBeforeLastCritical = 0;
+    for (const auto& d : lowData) {
+        if (d.order < lastCritical) {
+            ++lowBeforeLastCritical;
+        }
+    }
+
+    // Another worker may start a Low job while the last Critical one is being picked
+    EXPECT_LT(lowBeforeLastCritical, static_cast<int>(js.getWorkerCount()));
+}
+
+TEST_F(JobSystemTest, ParallelForVisitsEachIndexOnce)
+{
+    constexpr uint32_t COUNT = 10000;
+    std::vector<std::atomic<int>> visits(COUNT);
+    for (auto& v : visits) {
+        v.store(0, std::memory_order_relaxed);
+    }
+
+    JobSystem::getInstance().parallelFor(0, COUNT, 16, [&](uint32_t first, uint32_t last) {
+        for (uint32_t i = first; i < last; ++i) {
+            visits[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        EXPECT_EQ(visits[i].load(), 1) << "index " << i;
+    }
+}
+
+TEST_F(JobSystemTest, ParallelForEmptyRange)
+{
+    bool called = false;
+    JobSystem::getInstance().parallelFor(5, 5, 0, [&](uint32_t, uint32_t) { called = true; });
+    EXPECT_FALSE(called);
+}
+
+TEST_F(JobSystemTest, ParallelReduce)
+{
+    constexpr uint32_t COUNT = 100000;
+    uint64_t sum = JobSystem::getInstance().parallelReduce(
+        0, COUNT, 0, uint64_t(0),
+        [](uint32_t first, uint32_t last) {
+            uint64_t partial = 0;
+            for (uint32_t i = first; i < last; ++i) {
+                partial += i;
+            }
+            return partial;
+        },
+        [](uint64_t a, uint64_t b) { return a + b; });
+
+    EXPECT_EQ(sum, uint64_t(COUNT) * (COUNT - 1) / 2);
+}
+
+TEST_F(JobSystemTest, GrainSizeAdaptsToWorkerCount)
+{
+    auto& js = JobSystem::getInstance();
+    const uint32_t numThreads = js.getWorkerCount() + 1;
+
+    EXPECT_EQ(js.getGrainSize(10, 0), 1u);
+    EXPECT_EQ(js.getGrainSize(10, 100), 100u);
+    EXPECT_GE(js.getGrainSize(100000, 1) * numThreads * JobSystem::PARALLEL_SPLITS_PER_THREAD,
+              100000u);
+}
+
+TEST_F(JobSystemTest, ContinuationRunsAfterAntecedent)
+{
+    auto& js = JobSystem::getInstance();
+    std::atomic<int> order{0};
+    int firstOrder = -1;
+    int secondOrder = -1;
+    OrderData firstData{&order, &firstOrder};
+    OrderData secondData{&order, &secondOrder};
+
+    auto function = [](void* data) {
+        auto* d = static_cast<OrderData*>(data);
+        *d->executionOrder = d->orderCounter->fetch_add(1, std::memory_order_seq_cst);
+    };
+
+    auto first = js.createJob(function, &firstData);
+    auto second = js.createContinuation(first, function, &secondData);
+    ASSERT_TRUE(second.isValid());
+
+    // Running the continuation first only marks it as submitted
+    js.run(second);
+    EXPECT_FALSE(js.isComplete(second));
+    js.run(first);
+    js.wait(second);
+
+    EXPECT_EQ(firstOrder, 0);
+    EXPECT_EQ(secondOrder, 1);
+}
+
+TEST_F(JobSystemTest, ContinuationLimit)
+{
+    auto& js = JobSystem::getInstance();
+    auto antecedent = js.createJob([](void*) {});
+
+    std::vector<JobHandle> continuations;
+    for (size_t i = 0; i < MAX_JOB_CONTINUATIONS; ++i) {
+        auto continuation = js.createContinuation(antecedent, [](void*) {});
+        EXPECT_TRUE(continuation.isValid());
+        continuations.push_back(continuation);
+    }
+    EXPECT_FALSE(js.createContinuation(antecedent, [](void*) {}).isValid());
+
+    for (auto& continuation : continuations) {
+        js.run(continuation);
+    }
+    js.run(antecedent);
+    js.waitAll();
+
+    for (auto& continuation : continuations) {
+        EXPECT_TRUE(js.isComplete(continuation));
+    }
+}
+
+TEST_F(JobSystemTest, TaskGraphOrderAndResubmit)
+{
+    auto& js = JobSystem::getInstance();
+    std::atomic<int> order{0};
+    int update = -1;
+    int cullA = -1;
+    int cullB = -1;
+    int submit = -1;
+    OrderData updateData{&order, &update};
+    OrderData cullAData{&order, &cullA};
+    OrderData cullBData{&order, &cullB};
+    OrderData submitData{&order, &submit};
+
+    auto function = [](void* data) {
+        auto* d = static_cast<OrderData*>(data);
+        *d->executionOrder = d->orderCounter->fetch_add(1, std::memory_order_seq_cst);
+    };
+
+    // update -> (cullA, cullB) -> submit
+    TaskGraph graph;
+    auto updateTask = graph.addTask(function, &updateData);
+    auto cullATask = graph.addTask(function, &cullAData);
+    auto cullBTask = graph.addTask(function, &cullBData);
+    auto submitTask = graph.addTask(function, &submitData);
+    graph.addDependency(updateTask, cullATask);
+    graph.addDependency(updateTask, cullBTask);
+    graph.addDependency(cullATask, submitTask);
+    graph.addDependency(cullBTask, submitTask);
+
+    for (int frame = 0; frame < 3; ++frame) {
+        order.store(0);
+        JobHandle done = graph.submit(js);
+        js.wait(done);
+
+        EXPECT_EQ(update, 0);
+        EXPECT_GT(cullA, update);
+        EXPECT_GT(cullB, update);
+        EXPECT_EQ(submit, 3);
+    }
+}
+
+TEST_F(JobSystemTest, TaskGraphLargeFanOut)
+{
+    constexpr int NUM_SUCCESSORS = 40;
+    auto& js = JobSystem::getInstance();
+    std::atomic<bool> sourceDone{false};
+    std::atomic<int> violations{0};
+    std::atomic<int> executed{0};
+
+    struct FanOutData {
+        std::atomic<bool>* sourceDone;
+        std::atomic<int>* violations;
+        std::atomic<int>* executed;
+    } data{&sourceDone, &violations, &executed};
+
+    TaskGraph graph;
+    auto source = graph.addTask(
+        [](void* d) { static_cast<FanOutData*>(d)->sourceDone->store(true); }, &data);
+    for (int i = 0; i < NUM_SUCCESSORS; ++i) {
+        auto task = graph.addTask(
+            [](void* d) {
+                auto* f = static_cast<FanOutData*>(d);
+                if (!f->sourceDone->load()) {
+                    f->violations->fetch_add(1);
+                }
+                f->executed->fetch_add(1);
+            },
+            &data);
+        graph.addDependency(source, task);
+    }
+
+    js.wait(graph.submit(js));
+
+    EXPECT_EQ(executed.load(), NUM_SUCCESSORS);
+    EXPECT_EQ(violations.load(), 0);
+}
+
 // Test concurrent access to the queue
 TEST(WorkStealingQueueConcurrentTest, ConcurrentPushPop)
 {
@@ -355,3 +1144,54 @@ TEST(WorkStealingQueueConcurrentTest, ConcurrentPushPop)
     // Total retrieved should not exceed total pushed
     EXPECT_LE(popCount.load() + stealCount.load(), NUM_ITEMS);
 }
+
+TEST(WorkStealingQueueConcurrentTest, GrowWhileStealing)
+{
+    constexpr int NUM_ITEMS = 20000;
+    constexpr int NUM_STEALERS = 3;
+    WorkStealingQueue<int, 16> queue;
+    std::vector<std::atomic<int>> received(NUM_ITEMS);
+    for (auto& r : received) {
+        r.store(0, std::memory_order_relaxed);
+    }
+    std::atomic<int> taken{0};
+
+    auto take = [&](std::optional<int> item) {
+        if (item.has_value()) {
+            received[item.value()].fetch_add(1, std::memory_order_relaxed);
+            taken.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    // The owner pushes far beyond the initial capacity while thieves steal
+    std::thread owner([&]() {
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            queue.push(i);
+            if (i % 4 == 0) {
+                take(queue.pop());
+            }
+        }
+        while (taken.load(std::memory_order_relaxed) < NUM_ITEMS) {
+            take(queue.pop());
+        }
+    });
+
+    std::vector<std::thread> stealers;
+    for (int t = 0; t < NUM_STEALERS; ++t) {
+        stealers.emplace_back([&]() {
+            while (taken.load(std::memory_order_relaxed) < NUM_ITEMS) {
+                take(queue.steal());
+            }
+        });
+    }
+
+    owner.join();
+    for (auto& t : stealers) {
+        t.join();
+    }
+
+    // Every item was taken exactly once
+    for (int i = 0; i < NUM_ITEMS; ++i) {
+        EXPECT_EQ(received[i].load(), 1) << "item " << i;
+    }
+}
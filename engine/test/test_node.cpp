@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <ocf/base/Node.h>
+#include <ocf/base/PoolAllocated.h>
 #include <ocf/math/mat4.h>
 #include <ocf/renderer/Renderer.h>
 
@@ -90,4 +91,39 @@ TEST_F(NodeTest, GetSetGlobalZOrder) {
 TEST_F(NodeTest, Visit_DoesNotThrow) {
     math::mat4 transform;
     EXPECT_NO_THROW(node.visit(&renderer, transform, 0));
-}
\ No newline at end of file
+}
+
+class PooledNode : public Node, public PoolAllocated<PooledNode> {
+};
+
+class DerivedPooledNode : public PooledNode {
+public:
+    char padding[64] = {};
+};
+
+TEST(PoolAllocatedTest, NodesComeFromThePool)
+{
+    Node* parent = new Node();
+    std::vector<Node*> children;
+    for (int i = 0; i < 100; ++i) {
+        children.push_back(new PooledNode());
+        parent->addChild(children.back());
+    }
+    EXPECT_GE(PooledNode::getPoolCapacity(), 100u);
+    const size_t capacity = PooledNode::getPoolCapacity();
+
+    // Removed children go back to the pool and are reused
+    for (Node* child : children) {
+        parent->removeChild(child);
+    }
+    for (int i = 0; i < 100; ++i) {
+        parent->addChild(new PooledNode());
+    }
+    EXPECT_EQ(PooledNode::getPoolCapacity(), capacity);
+
+    // Larger derived classes use the heap
+    parent->addChild(new DerivedPooledNode());
+    EXPECT_EQ(PooledNode::getPoolCapacity(), capacity);
+
+    delete parent;
+}
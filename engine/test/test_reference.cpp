@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <ocf/base/AutoreleasePool.h>
 #include <ocf/base/Reference.h>
+#include <set>
+#include <thread>
+#include <vector>
 
 using namespace ocf;
 
@@ -11,6 +15,16 @@ public:
     int value;
 };
 
+// Counts the destroyed instances
+class TrackedRefCounted : public RefCounted {
+public:
+    explicit TrackedRefCounted(int& destroyed) : m_destroyed(destroyed) {}
+    ~TrackedRefCounted() { m_destroyed++; }
+
+private:
+    int& m_destroyed;
+};
+
 // RefCountedのデフォルトコンストラクタのテスト
 TEST(RefCountedTest, DefaultConstructor)
 {
@@ -229,3 +243,128 @@ TEST(RefTest, MultipleReferences)
     }
     // すべての参照がスコープを抜けた後、オブジェクトは削除される
 }
+
+// Refのコピー代入で古い参照が解放されるテスト
+TEST(RefTest, CopyAssignmentReleasesPrevious)
+{
+    int destroyed = 0;
+    Ref<TrackedRefCounted> ref1(new TrackedRefCounted(destroyed));
+    Ref<TrackedRefCounted> ref2(new TrackedRefCounted(destroyed));
+
+    ref1 = ref2;
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_EQ(ref2->getReferenceCount(), 2U);
+}
+
+// オブジェクトIDが複数スレッドで重複しないテスト
+TEST(ObjectTest, UniqueIdsAcrossThreads)
+{
+    constexpr int THREAD_COUNT = 4;
+    constexpr int COUNT = 1000;
+    std::vector<std::vector<unsigned int>> ids(THREAD_COUNT);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        threads.emplace_back([&ids, t]() {
+            for (int i = 0; i < COUNT; ++i) {
+                TestRefCounted obj;
+                ids[t].push_back(obj.getID());
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::set<unsigned int> unique;
+    for (const auto& threadIds : ids) {
+        unique.insert(threadIds.begin(), threadIds.end());
+    }
+    EXPECT_EQ(unique.size(), static_cast<size_t>(THREAD_COUNT * COUNT));
+}
+
+// 複数スレッドからのretain/releaseのテスト
+TEST(ObjectTest, ConcurrentRetainRelease)
+{
+    int destroyed = 0;
+    TrackedRefCounted* obj = new TrackedRefCounted(destroyed);
+    obj->retain();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([obj]() {
+            for (int i = 0; i < 10000; ++i) {
+                obj->retain();
+                obj->release();
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(obj->getReferenceCount(), 1U);
+    EXPECT_EQ(destroyed, 0);
+    obj->release();
+    EXPECT_EQ(destroyed, 1);
+}
+
+// autoreleaseされたオブジェクトがdrainで解放されるテスト
+TEST(AutoreleasePoolTest, DrainReleasesObjects)
+{
+    AutoreleasePool& pool = AutoreleasePool::getInstance();
+    pool.drain();
+
+    int destroyed = 0;
+    TrackedRefCounted* obj = new TrackedRefCounted(destroyed);
+    obj->autorelease();
+    EXPECT_EQ(obj->getReferenceCount(), 1U);
+    EXPECT_EQ(pool.getObjectCount(), 1U);
+
+    pool.drain();
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_EQ(pool.getObjectCount(), 0U);
+}
+
+// retainされたオブジェクトはdrain後も残るテスト
+TEST(AutoreleasePoolTest, RetainedObjectSurvivesDrain)
+{
+    AutoreleasePool& pool = AutoreleasePool::getInstance();
+    pool.drain();
+
+    int destroyed = 0;
+    TrackedRefCounted* obj = new TrackedRefCounted(destroyed);
+    obj->autorelease();
+    {
+        Ref<TrackedRefCounted> ref(obj);
+        pool.drain();
+        EXPECT_EQ(destroyed, 0);
+        EXPECT_EQ(obj->getReferenceCount(), 1U);
+    }
+    EXPECT_EQ(destroyed, 1);
+}
+
+// ワーカースレッドからのautoreleaseのテスト
+TEST(AutoreleasePoolTest, AutoreleaseFromThreads)
+{
+    AutoreleasePool& pool = AutoreleasePool::getInstance();
+    pool.drain();
+
+    int destroyed[4] = {};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&destroyed, t]() {
+            for (int i = 0; i < 100; ++i) {
+                (new TrackedRefCounted(destroyed[t]))->autorelease();
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(pool.getObjectCount(), 400U);
+    pool.drain();
+    for (int t = 0; t < 4; ++t) {
+        EXPECT_EQ(destroyed[t], 100);
+    }
+}
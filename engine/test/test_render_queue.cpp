@@ -0,0 +1,127 @@
+#include "renderer/RenderQueue.h"
+
+#include <gtest/gtest.h>
+#include <ocf/renderer/RenderCommand.h>
+#include <random>
+#include <vector>
+
+using namespace ocf;
+
+namespace {
+
+std::vector<RenderCommand*> collect(const RenderQueue& queue, RenderQueue::QueueGroup group)
+{
+    size_t begin = 0;
+    size_t end = 0;
+    queue.getSubQueueRange(group, begin, end);
+
+    std::vector<RenderCommand*> result;
+    for (size_t i = begin; i < end; i++) {
+        result.push_back(queue.getCommand(i));
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(RenderQueueTest, GroupsAreOrdered)
+{
+    RenderCommand positive, zero, negative, opaque, transparent;
+    positive.init(1.0f, math::mat4(1.0f));
+    negative.init(-1.0f, math::mat4(1.0f));
+    opaque.set3D(true);
+    transparent.set3D(true);
+    transparent.setTransparent(true);
+
+    RenderQueue queue;
+    for (RenderCommand* command : {&positive, &zero, &negative, &opaque, &transparent}) {
+        queue.emplace_back(command);
+    }
+    queue.sort();
+
+    ASSERT_EQ(queue.size(), 5u);
+    EXPECT_EQ(queue.getCommand(0), &negative);
+    EXPECT_EQ(queue.getCommand(1), &opaque);
+    EXPECT_EQ(queue.getCommand(2), &transparent);
+    EXPECT_EQ(queue.getCommand(3), &zero);
+    EXPECT_EQ(queue.getCommand(4), &positive);
+    for (int group = 0; group < RenderQueue::QUEUE_COUNT; group++) {
+        EXPECT_EQ(queue.getSubQueueSize(RenderQueue::QueueGroup(group)), 1u);
+    }
+}
+
+TEST(RenderQueueTest, SortsByGlobalOrderStably)
+{
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> distribution(-50, 50);
+
+    std::vector<RenderCommand> commands(5000);
+    RenderQueue queue;
+    for (RenderCommand& command : commands) {
+        command.init(static_cast<float>(distribution(random)) * 0.5f, math::mat4(1.0f));
+        queue.emplace_back(&command);
+    }
+    queue.sort();
+    EXPECT_EQ(queue.size(), commands.size());
+
+    std::vector<RenderCommand*> sorted = collect(queue, RenderQueue::GLOBALZ_NEG);
+    std::vector<RenderCommand*> positive = collect(queue, RenderQueue::GLOBALZ_POS);
+    sorted.insert(sorted.end(), positive.begin(), positive.end());
+    for (size_t i = 1; i < sorted.size(); i++) {
+        const float previous = sorted[i - 1]->getGlobalOrder();
+        const float current = sorted[i]->getGlobalOrder();
+        EXPECT_LE(previous, current);
+        if (previous == current) {
+            // Submission order, the commands are in one array
+            EXPECT_LT(sorted[i - 1], sorted[i]);
+        }
+    }
+}
+
+TEST(RenderQueueTest, KeepsSubmissionOrderOf2DCommands)
+{
+    std::vector<RenderCommand> commands(100);
+    RenderQueue queue;
+    for (size_t i = commands.size(); i > 0; i--) {
+        queue.emplace_back(&commands[i - 1]);
+    }
+    queue.sort();
+
+    std::vector<RenderCommand*> zero = collect(queue, RenderQueue::GLOBALZ_ZERO);
+    ASSERT_EQ(zero.size(), commands.size());
+    for (size_t i = 0; i < zero.size(); i++) {
+        EXPECT_EQ(zero[i], &commands[commands.size() - 1 - i]);
+    }
+}
+
+TEST(RenderQueueTest, SortsTransparentByDepth)
+{
+    std::vector<RenderCommand> commands(64);
+    RenderQueue queue;
+    for (size_t i = 0; i < commands.size(); i++) {
+        commands[i].set3D(true);
+        commands[i].setTransparent(true);
+        commands[i].setDepth(static_cast<float>((i * 37) % 64) - 32.0f);
+        queue.emplace_back(&commands[i]);
+    }
+    queue.sort();
+
+    std::vector<RenderCommand*> transparent = collect(queue, RenderQueue::TRANSPARENT_3D);
+    ASSERT_EQ(transparent.size(), commands.size());
+    for (size_t i = 1; i < transparent.size(); i++) {
+        EXPECT_LT(transparent[i - 1]->getDepth(), transparent[i]->getDepth());
+    }
+}
+
+TEST(RenderQueueTest, ClearResets)
+{
+    RenderCommand command;
+    RenderQueue queue;
+    queue.emplace_back(&command);
+    queue.sort();
+    queue.clear();
+    queue.sort();
+
+    EXPECT_EQ(queue.size(), 0u);
+    EXPECT_EQ(queue.getSubQueueSize(RenderQueue::GLOBALZ_ZERO), 0u);
+}
@@ -0,0 +1,140 @@
+#include "ocf/core/SlotMap.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <set>
+#include <vector>
+
+using namespace ocf;
+
+TEST(SlotMapTest, InsertAndGet)
+{
+    SlotMap<int> map;
+    SlotMap<int>::Key a = map.insert(1);
+    SlotMap<int>::Key b = map.emplace(2);
+
+    EXPECT_TRUE(a.isValid());
+    EXPECT_NE(a, b);
+    EXPECT_EQ(map.size(), 2u);
+    ASSERT_NE(map.get(a), nullptr);
+    EXPECT_EQ(*map.get(a), 1);
+    EXPECT_EQ(*map.get(b), 2);
+    EXPECT_FALSE(map.contains(SlotMap<int>::Key()));
+}
+
+TEST(SlotMapTest, EraseKeepsOtherKeys)
+{
+    SlotMap<int> map;
+    std::vector<SlotMap<int>::Key> keys;
+    for (int i = 0; i < 10; ++i) {
+        keys.push_back(map.insert(i));
+    }
+
+    EXPECT_TRUE(map.erase(keys[3]));
+    EXPECT_FALSE(map.erase(keys[3]));
+    EXPECT_FALSE(map.contains(keys[3]));
+    EXPECT_EQ(map.get(keys[3]), nullptr);
+    EXPECT_EQ(map.size(), 9u);
+
+    for (int i = 0; i < 10; ++i) {
+        if (i != 3) {
+            EXPECT_EQ(*map.get(keys[i]), i);
+        }
+    }
+}
+
+TEST(SlotMapTest, StaleKeyAfterReuse)
+{
+    SlotMap<int> map;
+    SlotMap<int>::Key first = map.insert(1);
+    map.erase(first);
+
+    // The slot is reused with a new generation
+    SlotMap<int>::Key second = map.insert(2);
+    EXPECT_NE(first, second);
+    EXPECT_FALSE(map.contains(first));
+    EXPECT_EQ(*map.get(second), 2);
+}
+
+TEST(SlotMapTest, IterationIsDense)
+{
+    SlotMap<int> map;
+    std::vector<SlotMap<int>::Key> keys;
+    for (int i = 0; i < 100; ++i) {
+        keys.push_back(map.insert(i));
+    }
+    for (int i = 0; i < 100; i += 2) {
+        map.erase(keys[i]);
+    }
+
+    std::set<int> values(map.begin(), map.end());
+    EXPECT_EQ(values.size(), 50u);
+    for (int value : values) {
+        EXPECT_EQ(value % 2, 1);
+    }
+
+    // Each position maps back to the key of its value
+    for (size_t i = 0; i < map.size(); ++i) {
+        EXPECT_EQ(*map.get(map.getKey(i)), map[i]);
+    }
+}
+
+TEST(SlotMapTest, EraseWhileIterating)
+{
+    SlotMap<int> map;
+    for (int i = 0; i < 20; ++i) {
+        map.insert(i);
+    }
+
+    for (size_t i = 0; i < map.size();) {
+        if (map[i] % 3 == 0) {
+            map.erase(map.getKey(i));
+        }
+        else {
+            ++i;
+        }
+    }
+
+    EXPECT_EQ(map.size(), 13u);
+    for (int value : map) {
+        EXPECT_NE(value % 3, 0);
+    }
+}
+
+TEST(SlotMapTest, ClearInvalidatesKeys)
+{
+    SlotMap<std::unique_ptr<int>> map;
+    auto key = map.insert(std::make_unique<int>(5));
+    map.clear();
+
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(key));
+    auto other = map.insert(std::make_unique<int>(6));
+    EXPECT_EQ(**map.get(other), 6);
+}
+
+TEST(SlotMapTest, KeyRoundTripsThroughId)
+{
+    SlotMap<int, 16> map;
+    auto key = map.insert(7);
+
+    // Ids fit in a non-negative int
+    EXPECT_GT(static_cast<int>(key.getId()), 0);
+    auto copy = SlotMap<int, 16>::Key::fromId(key.getId());
+    EXPECT_EQ(copy, key);
+    EXPECT_EQ(*map.get(copy), 7);
+}
+
+TEST(SlotMapTest, GenerationWrapsWithoutZero)
+{
+    // 2 bits of generation with 29 index bits
+    SlotMap<int, 29> map;
+    std::set<uint32_t> ids;
+    for (int i = 0; i < 10; ++i) {
+        auto key = map.insert(i);
+        EXPECT_TRUE(key.isValid());
+        ids.insert(key.getId());
+        map.erase(key);
+    }
+    // Generations 1, 2 and 3 only
+    EXPECT_EQ(ids.size(), 3u);
+}
@@ -0,0 +1,67 @@
+#include "renderer/VertexTransform.h"
+
+#include <gtest/gtest.h>
+#include <ocf/math/matrix_transform.h>
+#include <vector>
+
+using namespace ocf;
+using namespace ocf::math;
+
+namespace {
+
+std::vector<Vertex3fC3fT2f> makeVertices(unsigned int count)
+{
+    std::vector<Vertex3fC3fT2f> vertices(count);
+    for (unsigned int i = 0; i < count; i++) {
+        const float f = static_cast<float>(i);
+        vertices[i].position = vec3(f * 1.5f - 10.0f, 7.0f - f * 0.25f, f * 0.125f);
+        vertices[i].color = vec3(f, f + 0.5f, f + 0.25f);
+        vertices[i].texCoord = vec2(f * 0.5f, 1.0f - f);
+    }
+    return vertices;
+}
+
+} // namespace
+
+TEST(VertexTransformTest, MatchesScalar)
+{
+    // Translation, rotation around an oblique axis and non-uniform scale
+    mat4 matrix = translate(mat4(1.0f), vec3(12.0f, -3.5f, 0.75f));
+    matrix = rotate(matrix, 0.7f, normalize(vec3(1.0f, 2.0f, -0.5f)));
+    matrix = scale(matrix, vec3(2.0f, 0.5f, 3.0f));
+    // Something in the last row, which must not affect x, y and z
+    matrix[0].w = 0.25f;
+    matrix[3].w = 2.0f;
+
+    constexpr unsigned int COUNT = 37;
+    const std::vector<Vertex3fC3fT2f> src = makeVertices(COUNT);
+    std::vector<Vertex3fC3fT2f> expected(COUNT);
+    std::vector<Vertex3fC3fT2f> actual(COUNT);
+    transformVerticesScalar(matrix, src.data(), expected.data(), COUNT);
+    transformVertices(matrix, src.data(), actual.data(), COUNT);
+
+    for (unsigned int i = 0; i < COUNT; i++) {
+        EXPECT_NEAR(actual[i].position.x, expected[i].position.x, 1e-4f) << "vertex " << i;
+        EXPECT_NEAR(actual[i].position.y, expected[i].position.y, 1e-4f) << "vertex " << i;
+        EXPECT_NEAR(actual[i].position.z, expected[i].position.z, 1e-4f) << "vertex " << i;
+        EXPECT_EQ(actual[i].color, src[i].color) << "vertex " << i;
+        EXPECT_EQ(actual[i].texCoord, src[i].texCoord) << "vertex " << i;
+    }
+
+    // The translation is actually applied
+    EXPECT_NE(expected[0].position, src[0].position);
+}
+
+TEST(VertexTransformTest, IdentityKeepsVertices)
+{
+    constexpr unsigned int COUNT = 8;
+    const std::vector<Vertex3fC3fT2f> src = makeVertices(COUNT);
+    std::vector<Vertex3fC3fT2f> dst(COUNT);
+    transformVertices(mat4(1.0f), src.data(), dst.data(), COUNT);
+
+    for (unsigned int i = 0; i < COUNT; i++) {
+        EXPECT_EQ(dst[i].position, src[i].position);
+        EXPECT_EQ(dst[i].color, src[i].color);
+        EXPECT_EQ(dst[i].texCoord, src[i].texCoord);
+    }
+}